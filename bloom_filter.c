@@ -0,0 +1,47 @@
+#include "bloom_filter.h"
+
+static uint32_t Hash(const char *word, int length) {
+    // FNV-1a over the lower case word.
+    uint32_t hash = 2166136261U;
+    for (int i = 0; i < length; ++i) {
+        char c = word[i];
+        if (c >= 'A' && c <= 'Z') c = c - 'A' + 'a';
+        hash = (hash ^ (uint8_t) c) * 16777619U;
+    }
+    return hash;
+}
+
+static uint32_t Mix(uint32_t hash) {
+    // Murmur3 finaliser, a second hash from the first.
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6BU;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35U;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// Bit i of a word is h1 + i * h2, so the word is read once
+// whatever the number of hashes.
+#define BLOOM_BIT(h1, h2, i) ((h1) + (uint32_t) (i) * (h2))
+
+void BloomAdd(const struct BloomFilter *filter, uint8_t *bits,
+              const char *word, int length) {
+    uint32_t h1 = Hash(word, length);
+    uint32_t h2 = Mix(h1) | 1;
+    for (int i = 0; i < filter->hashes; ++i) {
+        uint32_t bit = BLOOM_BIT(h1, h2, i) % filter->bit_count;
+        bits[bit >> 3] |= 1 << (bit & 7);
+    }
+}
+
+bool BloomContains(const struct BloomFilter *filter, const char *word,
+                   int length) {
+    uint32_t h1 = Hash(word, length);
+    uint32_t h2 = Mix(h1) | 1;
+    for (int i = 0; i < filter->hashes; ++i) {
+        uint32_t bit = BLOOM_BIT(h1, h2, i) % filter->bit_count;
+        if (!(filter->bits[bit >> 3] & 1 << (bit & 7))) return false;
+    }
+    return true;
+}
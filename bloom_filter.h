@@ -0,0 +1,23 @@
+#ifndef _BLOOM_FILTER_H
+#define _BLOOM_FILTER_H 1
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// A set of words in a fixed number of bits, answering "maybe" or
+// "no". Each word sets hashes bits, so a word not in the set is
+// taken for one only if all of its bits were set by others.
+struct BloomFilter {
+    uint32_t bit_count;
+    int hashes;
+    const uint8_t *bits;
+};
+
+// Words are case insensitive. Filters are built on the host, into
+// a writable copy of the bits, see host/spellgen.c.
+void BloomAdd(const struct BloomFilter *filter, uint8_t *bits,
+              const char *word, int length);
+bool BloomContains(const struct BloomFilter *filter, const char *word,
+                   int length);
+
+#endif
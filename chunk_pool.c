@@ -0,0 +1,58 @@
+#include "chunk_pool.h"
+
+uint8_t chunk_arena[PACKED_SIZE(POOL_CHUNKS * CHUNK_SYMBOLS)];
+
+static int references[POOL_CHUNKS];
+// Freed chunks, reused first.
+static uint16_t free_chunks[POOL_CHUNKS];
+static int free_count = 0;
+// Chunks from this one on have never been used.
+static int fresh_chunk = 0;
+static int used_chunks = 0;
+static int peak_used_chunks = 0;
+
+int ChunkAlloc(void) {
+    int chunk;
+    if (free_count > 0) {
+        chunk = free_chunks[--free_count];
+    } else if (fresh_chunk < POOL_CHUNKS) {
+        chunk = fresh_chunk++;
+    } else {
+        return -1;
+    }
+    if (++used_chunks > peak_used_chunks) {
+        peak_used_chunks = used_chunks;
+    }
+    return chunk;
+}
+
+int ChunkFreeCount(void) {
+    return free_count + POOL_CHUNKS - fresh_chunk;
+}
+
+void ChunkRetain(int chunk, int symbols) {
+    references[chunk] += symbols;
+}
+
+void ChunkRelease(int chunk, int symbols) {
+    references[chunk] -= symbols;
+    if (!references[chunk] && symbols) {
+        free_chunks[free_count++] = chunk;
+        --used_chunks;
+    }
+}
+
+int ChunkReferences(int chunk) {
+    return references[chunk];
+}
+
+void ChunkPoolReport(struct ChunkPoolUsage *usage) {
+    usage->used_chunks = used_chunks;
+    usage->peak_used_chunks = peak_used_chunks;
+    usage->referenced_symbols = 0;
+    for (int i = 0; i < fresh_chunk; ++i) {
+        // Shared symbols are counted once per reference.
+        usage->referenced_symbols += references[i] < CHUNK_SYMBOLS
+                                     ? references[i] : CHUNK_SYMBOLS;
+    }
+}
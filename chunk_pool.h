@@ -0,0 +1,36 @@
+#ifndef _CHUNK_POOL_H
+#define _CHUNK_POOL_H 1
+
+#include <stdint.h>
+#include "packed_text.h"
+
+// Text is kept in fixed-size chunks of one statically allocated
+// arena. Chunks are allocated and freed in O(1) and, all being
+// the same size, the arena cannot fragment.
+#define CHUNK_SYMBOLS 256
+#ifndef POOL_CHUNKS
+#define POOL_CHUNKS 256
+#endif
+
+// Packed symbols, chunk c holds those from c * CHUNK_SYMBOLS on.
+extern uint8_t chunk_arena[PACKED_SIZE(POOL_CHUNKS * CHUNK_SYMBOLS)];
+
+struct ChunkPoolUsage {
+    int used_chunks;
+    int peak_used_chunks;
+    // Symbols of the used chunks that some text refers to, the rest
+    // of the used chunks is wasted.
+    int referenced_symbols;
+};
+
+// Returns -1 when the pool is exhausted.
+int ChunkAlloc(void);
+int ChunkFreeCount(void);
+// References are counted in symbols. A chunk is freed when
+// none of its symbols is referred to.
+void ChunkRetain(int chunk, int symbols);
+void ChunkRelease(int chunk, int symbols);
+int ChunkReferences(int chunk);
+void ChunkPoolReport(struct ChunkPoolUsage *usage);
+
+#endif
@@ -0,0 +1,641 @@
+#include <stdbool.h>
+#include "editor.h"
+#include "lcd_geometry.h"
+#include "line_index.h"
+#include "piece_table.h"
+#include "synced_lcd.h"
+#include "text_search.h"
+
+// The screen follows from the font, see lcd_geometry.h.
+#define SCREEN_WIDTH LCD_TEXT_WIDTH
+#define SCREEN_HEIGHT LCD_TEXT_HEIGHT
+// Text is read in windows of this many characters when indexing
+// its lines.
+#define LINES_WINDOW 64
+// Held arrows and backspace move by words after this many
+// single character repeats.
+#define REPEATS_BEFORE_WORD_STEP 6
+// Attributes of the cells showing the editor state.
+#define CURSOR_ATTRIBUTES ATTR_INVERSE
+#define TEMPORARY_CURSOR_ATTRIBUTES (ATTR_FG_YELLOW | ATTR_INVERSE)
+#define SELECTION_ATTRIBUTES ATTR_BG_BLACK
+#define MATCH_ATTRIBUTES (ATTR_FG_BLACK | ATTR_BG_GREEN)
+
+// Keyboard layout definition. The third press of 0 starts a new line.
+char* layout[4][4] = {
+    {"1", "abc2", "def3", ""},     
+    {"ghi4", "jkl5", "mno6", ""},
+    {"prs7", "tuv8", "wxy9", ""},
+    {"*", " 0\n", "#", ""},
+};
+
+struct Button {
+    int row;
+    int col;
+};
+
+// Special button: left arrow.
+const struct Button LEFT_BUTTON = {0, 3};
+
+// Special button: backspace.
+const struct Button BACKSPACE_BUTTON = {1, 3};
+
+// Special button: clear.
+const struct Button CLEAR_BUTTON = {2, 3};
+
+// Special button: right arrow.
+const struct Button RIGHT_BUTTON = {3, 3};
+
+// Long press switches to the next document.
+const struct Button NEXT_DOCUMENT_BUTTON = {0, 0};
+
+// Long press starts selecting, in selection mode copies.
+const struct Button COPY_BUTTON = {3, 2};
+
+// In selection mode pastes, long press starts searching.
+const struct Button PASTE_BUTTON = {3, 0};
+
+// Is roundabout on? Which button?
+struct Button current_roundabout_button = {-1, -1};
+
+// Which choice, e.g. 0 for a, 1 for b.
+int current_roundabout_position = 0;
+
+// A document slot, its cursor and scroll are saved while
+// another document is edited.
+struct Document {
+    struct PieceTable text;
+    int cursor_position;
+    int viewport_row;
+};
+
+// All documents and the clipboard share the chunk pool. Copy and
+// paste only exchange references to the text, see piece_table.h.
+struct Document documents[DOCUMENT_SLOTS];
+int current_document = 0;
+struct PieceTable *document = &documents[0].text;
+struct PieceTable clipboard;
+// Where the newlines of the clipboard are, taken from the line index
+// when copying, so that a paste indexes its lines without reading
+// the text.
+int32_t clipboard_newlines[LINE_INDEX_MAX_LINES];
+int clipboard_newline_count = 0;
+int cursor_position = 0;
+
+// Lines of the current document, kept up to date by every edit and
+// indexed anew when switching documents.
+struct LineIndex lines;
+
+// First text row shown on the screen.
+int viewport_row = 0;
+
+// Selection mode: the text between the anchor and the cursor
+// is selected.
+bool selecting = false;
+int selection_anchor = 0;
+
+// Search mode: typed characters extend the query instead of
+// the text, the cursor follows the match.
+bool searching = false;
+struct Search search;
+
+// What the current press did, to tell what holding it means.
+bool press_repeats = false;
+bool press_added_char = false;
+
+// Set by every redraw, to tell whether a key drew anything.
+bool viewport_synchronised = false;
+
+int SelectionFrom(void) {
+    return selection_anchor < cursor_position ? selection_anchor
+                                              : cursor_position;
+}
+
+int SelectionTo(void) {
+    return selection_anchor < cursor_position ? cursor_position
+                                              : selection_anchor;
+}
+
+uint8_t CursorAttributes(void) {
+    return current_roundabout_button.row != -1 ? TEMPORARY_CURSOR_ATTRIBUTES
+                                               : CURSOR_ATTRIBUTES;
+}
+
+uint8_t StateAttributes(int position) {
+    // The state is shown through cell attributes, the text keeps
+    // its layout: the cursor is the inverse cell at its position,
+    // yellow after a temporary character, and the selection and the
+    // match have a background of their own.
+    uint8_t attributes = ATTR_DEFAULT;
+    if (selecting && position >= SelectionFrom() &&
+        position < SelectionTo()) {
+        attributes = SELECTION_ATTRIBUTES;
+    }
+    if (!searching && position == cursor_position) {
+        attributes = CursorAttributes();
+    }
+    return attributes;
+}
+
+void SynchroniseSearchQuery(int row) {
+    // The query takes the last row: '?' or '!' if it is not found,
+    // its end and the cursor.
+    int length;
+    SearchFound(&search, &length);
+    SyncedLCDgoto(row, 0);
+    SyncedLCDsetAttributes(ATTR_DEFAULT);
+    SyncedLCDputcharWrap(length == search.length ? '?' : '!');
+    int shown = search.length < SCREEN_WIDTH - 2 ? search.length
+                                                 : SCREEN_WIDTH - 2;
+    for (int i = search.length - shown; i < search.length; ++i) {
+        SyncedLCDputcharWrap(search.query[i]);
+    }
+    SyncedLCDsetAttributes(CursorAttributes());
+    SyncedLCDputcharWrap(' ');
+    SyncedLCDsetAttributes(ATTR_DEFAULT);
+    for (int i = shown + 2; i < SCREEN_WIDTH; ++i) {
+        SyncedLCDputcharWrap(' ');
+    }
+}
+
+void SynchroniseViewport(void) {
+    // Redraws the whole screen in a single pass. Only the cells
+    // that really changed are sent to the LCD by SyncedLCDsync.
+    viewport_synchronised = true;
+    int rows = searching ? SCREEN_HEIGHT - 1 : SCREEN_HEIGHT;
+
+    // Scroll to keep the cursor on the screen.
+    int cursor_col;
+    int cursor_row = LineIndexRowOf(&lines, cursor_position, &cursor_col);
+    if (cursor_row < viewport_row) {
+        viewport_row = cursor_row;
+    } else if (cursor_row >= viewport_row + rows) {
+        viewport_row = cursor_row - rows + 1;
+    }
+
+    // While searching the cursor follows the query instead and the
+    // match is highlighted.
+    int match_length = 0;
+    int match = searching ? SearchFound(&search, &match_length) : 0;
+    SyncedLCDgoto(0, 0);
+    for (int row = 0; row < rows; ++row) {
+        char cells[SCREEN_WIDTH];
+        int length;
+        int start = LineIndexRowStart(&lines, viewport_row + row, &length);
+        if (start >= 0) {
+            PieceTableRead(document, start, length, cells);
+        }
+        for (int col = 0; col < SCREEN_WIDTH; ++col) {
+            // Past the characters of a row only its newline, or the
+            // end of the text, has a position.
+            int position = start >= 0 && col <= length ? start + col : -1;
+            if (position >= match && position < match + match_length) {
+                SyncedLCDsetAttributes(MATCH_ATTRIBUTES);
+            } else {
+                SyncedLCDsetAttributes(StateAttributes(position));
+            }
+            SyncedLCDputcharWrap(col < length ? cells[col] : ' ');
+        }
+    }
+    if (searching) {
+        SynchroniseSearchQuery(rows);
+    }
+}
+
+void LinesInsert(int position, struct PieceTable *text) {
+    // Indexes the whole text, just inserted at the position.
+    char window[LINES_WINDOW];
+    for (int offset = 0; offset < text->length;) {
+        int count = PieceTableRead(text, offset, LINES_WINDOW, window);
+        LineIndexInsert(&lines, position + offset, window, count);
+        offset += count;
+    }
+}
+
+bool LinesFit(char c) {
+    return c != '\n' || LineIndexCanInsert(&lines, 1);
+}
+
+void StoreCollect(void) {
+    // Frees the chunks wasted by text deleted from any document.
+    struct PieceTable *tables[DOCUMENT_SLOTS + 1];
+    for (int i = 0; i < DOCUMENT_SLOTS; ++i) {
+        tables[i] = &documents[i].text;
+    }
+    tables[DOCUMENT_SLOTS] = &clipboard;
+    PieceTableCollect(tables, DOCUMENT_SLOTS + 1);
+}
+
+void BufferReplaceChar(char new_char) {
+    int position = cursor_position - 1;
+    char old_char = PieceTableCharAt(document, position);
+    bool replaced = old_char == '\n' || LinesFit(new_char);
+    if (replaced && !PieceTableReplace(document, position, new_char)) {
+        StoreCollect();
+        replaced = PieceTableReplace(document, position, new_char);
+    }
+    if (replaced && (old_char == '\n' || new_char == '\n')) {
+        LineIndexDelete(&lines, position, 1);
+        LineIndexInsert(&lines, position, &new_char, 1);
+    }
+    SynchroniseViewport();
+}
+
+void BufferClear(void) {
+    PieceTableClear(document);
+    LineIndexClear(&lines, SCREEN_WIDTH);
+    cursor_position = 0;
+    viewport_row = 0;
+    selecting = false;
+    SynchroniseViewport();
+}
+
+void BufferDeleteBackward(int count) {
+    // Removes up to count characters before the cursor
+    // in a single operation.
+    if (count > cursor_position) count = cursor_position;
+    if (count <= 0) return;
+    bool deleted = PieceTableDelete(document, cursor_position - count, count);
+    if (!deleted) {
+        StoreCollect();
+        deleted = PieceTableDelete(document, cursor_position - count, count);
+    }
+    if (deleted) {
+        LineIndexDelete(&lines, cursor_position - count, count);
+        cursor_position -= count;
+    }
+    SynchroniseViewport();
+}
+
+void BufferBackspace(void) {
+    BufferDeleteBackward(1);
+}
+
+void BufferAdd(char new_char) {
+    // The cursor after a temporary character is yellow until it is
+    // fixed, see CursorAttributes.
+    if (LinesFit(new_char) &&
+        PieceTableInsert(document, cursor_position, new_char)) {
+        LineIndexInsert(&lines, cursor_position, &new_char, 1);
+        ++cursor_position;
+    }
+    SynchroniseViewport();
+}
+
+void BufferMoveTo(int position) {
+    // a_bc -> abc_ or any other jump.
+    if (position < 0) position = 0;
+    if (position > document->length) position = document->length;
+    cursor_position = position;
+    SynchroniseViewport();
+}
+
+void BufferMoveLeft(void) {
+    BufferMoveTo(cursor_position - 1);
+}
+
+void BufferMoveRight(void) {
+    BufferMoveTo(cursor_position + 1);
+}
+
+void BufferPaste(void) {
+    bool pasted = LineIndexCanInsert(&lines, clipboard_newline_count);
+    if (pasted && !PieceTablePaste(document, cursor_position, &clipboard)) {
+        StoreCollect();
+        pasted = PieceTablePaste(document, cursor_position, &clipboard);
+    }
+    if (pasted) {
+        LineIndexInsertNewlines(&lines, cursor_position, clipboard.length,
+                                clipboard_newlines, clipboard_newline_count);
+        cursor_position += clipboard.length;
+    }
+    SynchroniseViewport();
+}
+
+void DocumentSwitch(int slot) {
+    // Saves the cursor of the current document and shows another one.
+    documents[current_document].cursor_position = cursor_position;
+    documents[current_document].viewport_row = viewport_row;
+    current_document = slot;
+    document = &documents[slot].text;
+    cursor_position = documents[slot].cursor_position;
+    viewport_row = documents[slot].viewport_row;
+    LineIndexClear(&lines, SCREEN_WIDTH);
+    LinesInsert(0, document);
+    selecting = false;
+    SynchroniseViewport();
+}
+
+bool IsSpace(char c) {
+    return c == ' ' || c == '\n';
+}
+
+int PreviousWordStart(int position) {
+    while (position > 0 &&
+           IsSpace(PieceTableCharAt(document, position - 1))) {
+        --position;
+    }
+    while (position > 0 &&
+           !IsSpace(PieceTableCharAt(document, position - 1))) {
+        --position;
+    }
+    return position;
+}
+
+int NextWordStart(int position) {
+    while (position < document->length &&
+           !IsSpace(PieceTableCharAt(document, position))) {
+        ++position;
+    }
+    while (position < document->length &&
+           IsSpace(PieceTableCharAt(document, position))) {
+        ++position;
+    }
+    return position;
+}
+
+void BufferFix(void) {
+    SynchroniseViewport();
+}
+
+bool BufferIsFull(void) {
+    if (PieceTableCanInsert(document)) return false;
+    StoreCollect();
+    return !PieceTableCanInsert(document);
+}
+
+void SelectionBegin(void) {
+    selecting = true;
+    selection_anchor = cursor_position;
+    SynchroniseViewport();
+}
+
+void SelectionCopy(void) {
+    int from = SelectionFrom();
+    int count = SelectionTo() - from;
+    PieceTableCopy(document, from, count, &clipboard);
+    clipboard_newline_count =
+        LineIndexNewlines(&lines, from, count, clipboard_newlines);
+}
+
+void SelectionDelete(void) {
+    int from = SelectionFrom();
+    int count = SelectionTo() - from;
+    bool deleted = PieceTableDelete(document, from, count);
+    if (!deleted) {
+        StoreCollect();
+        deleted = PieceTableDelete(document, from, count);
+    }
+    if (deleted) {
+        LineIndexDelete(&lines, from, count);
+        cursor_position = from;
+    }
+    selection_anchor = cursor_position;
+}
+
+void SelectionEnd(void) {
+    selecting = false;
+    SynchroniseViewport();
+}
+
+void SelectionButtonPressed(int row, int col) {
+    // In selection mode arrows extend the selection, '#' copies it,
+    // backspace cuts it, '*' replaces it with the clipboard and
+    // clear leaves the mode.
+    if (LEFT_BUTTON.row == row && LEFT_BUTTON.col == col) {
+        BufferMoveLeft();
+        press_repeats = true;
+    } else if (RIGHT_BUTTON.row == row && RIGHT_BUTTON.col == col) {
+        BufferMoveRight();
+        press_repeats = true;
+    } else if (COPY_BUTTON.row == row && COPY_BUTTON.col == col) {
+        SelectionCopy();
+        SelectionEnd();
+    } else if (BACKSPACE_BUTTON.row == row && BACKSPACE_BUTTON.col == col) {
+        SelectionCopy();
+        SelectionDelete();
+        SelectionEnd();
+    } else if (PASTE_BUTTON.row == row && PASTE_BUTTON.col == col) {
+        SelectionDelete();
+        selecting = false;
+        BufferPaste();
+    } else if (CLEAR_BUTTON.row == row && CLEAR_BUTTON.col == col) {
+        SelectionEnd();
+    }
+}
+
+void SearchBegin(void) {
+    searching = true;
+    SearchStart(&search, cursor_position);
+    SynchroniseViewport();
+}
+
+void SearchFollow(void) {
+    // Moves the cursor to the match, or to where the longest
+    // prefix of the query was found.
+    int length;
+    cursor_position = SearchFound(&search, &length);
+    SynchroniseViewport();
+}
+
+void SearchAdd(char c) {
+    if (SearchPush(&search, document, c)) {
+        SearchFollow();
+    }
+}
+
+void SearchReplaceChar(char c) {
+    // The match of the prefix stays, only the last character
+    // is searched for again.
+    SearchPop(&search);
+    SearchAdd(c);
+}
+
+void SearchEnd(void) {
+    searching = false;
+    SynchroniseViewport();
+}
+
+void SearchButtonPressed(int row, int col) {
+    // In search mode right arrow moves to the next match, backspace
+    // shortens the query and clear leaves the mode with the cursor
+    // at the match.
+    if (RIGHT_BUTTON.row == row && RIGHT_BUTTON.col == col) {
+        SearchNext(&search, document);
+        SearchFollow();
+    } else if (BACKSPACE_BUTTON.row == row && BACKSPACE_BUTTON.col == col) {
+        SearchPop(&search);
+        SearchFollow();
+    } else if (CLEAR_BUTTON.row == row && CLEAR_BUTTON.col == col) {
+        SearchEnd();
+    }
+}
+
+void InputAdd(char c) {
+    if (searching) {
+        SearchAdd(c);
+    } else {
+        BufferAdd(c);
+    }
+}
+
+void ButtonRepeat(void) {
+    current_roundabout_position++;
+    if (!layout[current_roundabout_button.row]
+               [current_roundabout_button.col]
+               [current_roundabout_position]) {
+        current_roundabout_position = 0;
+    }
+    char current_char = layout[current_roundabout_button.row]
+               [current_roundabout_button.col]
+               [current_roundabout_position];
+    if (searching) {
+        SearchReplaceChar(current_char);
+    } else {
+        BufferReplaceChar(current_char);
+    }
+}
+
+void OtherButtonPressed(int row, int col) {
+    if (selecting) {
+        SelectionButtonPressed(row, col);
+    } else if (searching && !*layout[row][col]) {
+        // Arrows, backspace and clear.
+        SearchButtonPressed(row, col);
+    } else if (LEFT_BUTTON.row == row && LEFT_BUTTON.col == col) {
+        BufferMoveLeft();
+        press_repeats = true;
+    } else if (CLEAR_BUTTON.row == row && CLEAR_BUTTON.col == col) {
+        BufferClear();
+    } else if(BACKSPACE_BUTTON.row == row && BACKSPACE_BUTTON.col == col) {
+        BufferBackspace();
+        press_repeats = true;
+    } else if (RIGHT_BUTTON.row == row && RIGHT_BUTTON.col == col) {
+        BufferMoveRight();
+        press_repeats = true;
+    } else {
+        if (searching ? search.length == SEARCH_MAX_QUERY
+                      : BufferIsFull()) return;
+        char* choice = layout[row][col];
+        if (*choice && choice[1]) {
+            current_roundabout_button.row = row;
+            current_roundabout_button.col = col;
+            InputAdd(*choice);
+
+        } else if (*choice) {
+            InputAdd(*choice);
+            press_added_char = !searching;
+        }
+    }
+}
+
+void ButtonPressed(int row, int col) {
+    press_repeats = false;
+    press_added_char = false;
+    if (current_roundabout_button.row == row &&
+        current_roundabout_button.col == col) {
+        ButtonRepeat();
+    } else {
+        // Another key fixes the temporary character. The key redraws
+        // its cursor, unless it draws nothing, e.g. a letter when the
+        // query is full, and then the fix does.
+        bool was_temporary = current_roundabout_button.row != -1;
+        current_roundabout_button.row = -1;
+        current_roundabout_button.col = -1;
+        current_roundabout_position = 0;
+        viewport_synchronised = false;
+        OtherButtonPressed(row, col);
+        if (was_temporary && !viewport_synchronised) {
+            BufferFix();
+        }
+    }
+}
+
+void ButtonHeld(int row, int col, int repeat) {
+    if (press_added_char && repeat == 0 &&
+        COPY_BUTTON.row == row && COPY_BUTTON.col == col) {
+        // Long press on '#' takes the character back and starts
+        // selecting.
+        BufferBackspace();
+        SelectionBegin();
+        return;
+    }
+    if (press_added_char && repeat == 0 &&
+        NEXT_DOCUMENT_BUTTON.row == row && NEXT_DOCUMENT_BUTTON.col == col) {
+        // Long press on '1' takes the character back and switches
+        // to the next document.
+        BufferBackspace();
+        DocumentSwitch((current_document + 1) % DOCUMENT_SLOTS);
+        return;
+    }
+    if (press_added_char && repeat == 0 &&
+        PASTE_BUTTON.row == row && PASTE_BUTTON.col == col) {
+        // Long press on '*' takes the character back and starts
+        // searching from the cursor.
+        BufferBackspace();
+        SearchBegin();
+        return;
+    }
+    if (!press_repeats) return;
+
+    // Arrows and backspace auto-repeat by characters first and
+    // by whole words when held longer.
+    bool by_word = repeat >= REPEATS_BEFORE_WORD_STEP;
+    if (LEFT_BUTTON.row == row && LEFT_BUTTON.col == col) {
+        BufferMoveTo(by_word ? PreviousWordStart(cursor_position)
+                             : cursor_position - 1);
+    } else if (BACKSPACE_BUTTON.row == row && BACKSPACE_BUTTON.col == col) {
+        BufferDeleteBackward(by_word
+            ? cursor_position - PreviousWordStart(cursor_position) : 1);
+    } else if (RIGHT_BUTTON.row == row && RIGHT_BUTTON.col == col) {
+        BufferMoveTo(by_word ? NextWordStart(cursor_position)
+                             : cursor_position + 1);
+    }
+}
+
+void FixButton(void) {
+    bool was_temporary = current_roundabout_button.row != -1;
+    current_roundabout_button.row = -1;
+    current_roundabout_button.col = -1;
+    if (was_temporary) {
+        BufferFix();
+    }
+}
+
+void AmbiguousPress(void) {
+    // Ambiguous press - do nothing, but holding it must not act
+    // on the press before.
+    press_repeats = false;
+    press_added_char = false;
+}
+
+void EditorConfigure(void) {
+    EditorReset();
+}
+
+void EditorReset(void) {
+    current_roundabout_button.row = -1;
+    current_roundabout_button.col = -1;
+    current_roundabout_position = 0;
+    press_repeats = false;
+    press_added_char = false;
+    searching = false;
+    for (int slot = 0; slot < DOCUMENT_SLOTS; ++slot) {
+        PieceTableClear(&documents[slot].text);
+        documents[slot].cursor_position = 0;
+        documents[slot].viewport_row = 0;
+    }
+    PieceTableClear(&clipboard);
+    clipboard_newline_count = 0;
+    current_document = 0;
+    document = &documents[0].text;
+    BufferClear();
+}
+
+struct PieceTable *EditorText(void) {
+    return document;
+}
+
+int EditorCursor(void) {
+    return cursor_position;
+}
@@ -0,0 +1,24 @@
+#ifndef _EDITOR_H
+#define _EDITOR_H 1
+
+// The editor handles the keyboard.h callbacks and draws
+// with synced_lcd.h.
+#include "keyboard.h"
+#include "piece_table.h"
+
+// Documents switched between by a long press on '1'.
+#ifndef DOCUMENT_SLOTS
+#define DOCUMENT_SLOTS 4
+#endif
+
+// Starts with empty documents, requires SyncedLCDconfigure.
+void EditorConfigure(void);
+
+// For the host tools. Empties the documents and the clipboard and
+// leaves every mode, as EditorConfigure starts.
+void EditorReset(void);
+// The text of the current document and the cursor in it.
+struct PieceTable *EditorText(void);
+int EditorCursor(void);
+
+#endif
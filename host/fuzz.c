@@ -0,0 +1,355 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "editor.h"
+#include "fuzz_model.h"
+#include "lcd.h"
+#include "piece_table.h"
+#include "screen.h"
+#include "synced_lcd.h"
+
+// Differential fuzzing of the editor: key sequences are fed both to
+// editor.c, drawing through synced_lcd.c, and to the reference model
+// of fuzz_model.c. After every event the text, the cursor and the
+// screen read back from the LCD stand-in must be those of the model.
+//
+//   fuzz [-n sequences] [-s seed] [-l length]   random sequences
+//   fuzz input...                               replays inputs
+//   fuzz -m input                               minimises to input.min
+//
+// An input is a byte per event: the key in the low nibble, row
+// first, and the action in the high one, see Apply. A failing
+// random sequence is written to failure-<seed>-<n> and its first
+// mismatch reported. "fuzz" reads the screen cell by cell from lcd.h
+// calls, "fuzz_spi" decodes the pixels lcd.c sent and runs a few
+// hundred times slower.
+//
+// Built with -DFUZZ_LIBFUZZER the main is left out for libFuzzer,
+// which aborts on a mismatch and minimises its corpus itself.
+
+#define DEFAULT_SEQUENCES 10000
+#define DEFAULT_LENGTH 200
+#define MAX_INPUT 65536
+
+// Actions of the high nibble; the others are plain presses.
+#define ACTION_FIX_AFTER 8
+#define ACTION_FIX 10
+#define ACTION_HELD 11
+#define ACTION_HELD_ON 12
+#define ACTION_HELD_LONG 13
+#define ACTION_AMBIGUOUS 14
+
+static struct Model model;
+static char text[MODEL_MAX_TEXT];
+static Screen expected;
+static Screen shown;
+
+static void Reset(void) {
+    static bool configured = false;
+    if (!configured) {
+        ScreenConfigure();
+        SyncedLCDconfigure();
+        EditorConfigure();
+        configured = true;
+    }
+    // Empty documents, as EditorConfigure leaves them, without
+    // configuring the LCD again.
+    EditorReset();
+    SyncedLCDsync();
+    ModelReset(&model);
+}
+
+static int Repeats(int action) {
+    switch (action) {
+    case ACTION_HELD: return 1;
+    case ACTION_HELD_ON: return 4;
+    case ACTION_HELD_LONG: return 10;
+    default: return 0;
+    }
+}
+
+static void Apply(uint8_t event) {
+    int row = (event & 15) >> 2;
+    int col = event & 3;
+    int action = event >> 4;
+    if (action == ACTION_FIX) {
+        FixButton();
+        ModelFix(&model);
+        return;
+    }
+    if (action == ACTION_AMBIGUOUS) {
+        AmbiguousPress();
+        return;
+    }
+    // Presses that would take the text past what the model holds
+    // are left out of both.
+    if (ModelPressOverflows(&model, row, col)) return;
+    ButtonPressed(row, col);
+    ModelPressed(&model, row, col);
+    for (int repeat = 0; repeat < Repeats(action); ++repeat) {
+        ButtonHeld(row, col, repeat);
+        ModelHeld(&model, row, col, repeat);
+    }
+    if (action == ACTION_FIX_AFTER || action == ACTION_FIX_AFTER + 1 ||
+        action == 15) {
+        FixButton();
+        ModelFix(&model);
+    }
+}
+
+static char CellState(const struct ScreenCell *cell) {
+    // A letter per colour pair, uppercase if underlined.
+    static const struct {
+        uint16_t text, back;
+        char name;
+    } states[] = {
+        {LCD_COLOR_WHITE, LCD_COLOR_BLUE, '.'},
+        {LCD_COLOR_BLUE, LCD_COLOR_WHITE, 'c'},
+        {LCD_COLOR_BLUE, LCD_COLOR_YELLOW, 't'},
+        {LCD_COLOR_WHITE, LCD_COLOR_BLACK, 's'},
+        {LCD_COLOR_BLACK, LCD_COLOR_GREEN, 'm'},
+    };
+    if (cell->garbled) return '#';
+    for (size_t i = 0; i < sizeof(states) / sizeof(states[0]); ++i) {
+        if (cell->text == states[i].text && cell->back == states[i].back) {
+            return cell->underline ? states[i].name - 'a' + 'A'
+                                   : states[i].name;
+        }
+    }
+    return '?';
+}
+
+static bool SameCell(const struct ScreenCell *a, const struct ScreenCell *b) {
+    return a->c == b->c && a->text == b->text && a->back == b->back &&
+           a->underline == b->underline && a->garbled == b->garbled;
+}
+
+static void PrintScreens(void) {
+    printf("  %-*s  shown\n", 2 * LCD_TEXT_WIDTH + 3, "expected");
+    for (int i = 0; i < LCD_TEXT_HEIGHT; ++i) {
+        char line[2][2][LCD_TEXT_WIDTH + 1];
+        for (int j = 0; j < LCD_TEXT_WIDTH; ++j) {
+            line[0][0][j] = expected[i][j].c;
+            line[0][1][j] = CellState(&expected[i][j]);
+            line[1][0][j] = shown[i][j].c;
+            line[1][1][j] = CellState(&shown[i][j]);
+        }
+        bool differs = false;
+        for (int j = 0; j < LCD_TEXT_WIDTH; ++j) {
+            differs |= !SameCell(&expected[i][j], &shown[i][j]);
+        }
+        for (int k = 0; k < 4; ++k) {
+            line[k / 2][k % 2][LCD_TEXT_WIDTH] = '\0';
+        }
+        printf("  |%s|%s|  |%s|%s|%s\n", line[0][0], line[0][1],
+               line[1][0], line[1][1], differs ? " <" : "");
+    }
+    printf("  . normal, c cursor, t temporary cursor, s selection, "
+           "m match,\n  uppercase underlined, # garbled\n");
+}
+
+static bool Check(int event, bool verbose) {
+    // Compares after the sync of the main loop.
+    SyncedLCDsync();
+    const struct ModelDocument *d = model.document;
+    struct PieceTable *document = EditorText();
+    int cursor_position = EditorCursor();
+    bool same_text = document->length == d->length;
+    for (int position = 0; same_text && position < d->length;) {
+        int count = PieceTableRead(document, position,
+                                   d->length - position, text);
+        same_text = count > 0 && !memcmp(text, d->text + position, count);
+        position += count;
+    }
+    if (!same_text || cursor_position != d->cursor) {
+        if (verbose) {
+            printf("event %d: text or cursor differs\n", event);
+            printf("  expected %d characters, cursor at %d: \"%.*s\"\n",
+                   d->length, d->cursor, d->length, d->text);
+            int length = PieceTableRead(document, 0, MODEL_MAX_TEXT, text);
+            printf("  got %d characters, cursor at %d: \"%.*s%s\"\n",
+                   document->length, cursor_position, length, text,
+                   length < document->length ? "..." : "");
+        }
+        return false;
+    }
+    ModelScreen(&model, expected);
+    ScreenRead(shown);
+    for (int i = 0; i < LCD_TEXT_HEIGHT; ++i) {
+        for (int j = 0; j < LCD_TEXT_WIDTH; ++j) {
+            if (SameCell(&expected[i][j], &shown[i][j])) continue;
+            if (verbose) {
+                printf("event %d: screen differs at row %d, column %d\n",
+                       event, i, j);
+                PrintScreens();
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns the index of the first event after which the editor and
+// the model differ, or -1.
+static int RunInput(const uint8_t *data, size_t size, bool verbose) {
+    Reset();
+    for (size_t i = 0; i < size; ++i) {
+        Apply(data[i]);
+        if (!Check(i, verbose)) {
+            if (verbose) {
+                printf("  event 0x%02x: action %d on key %d, %d\n", data[i],
+                       data[i] >> 4, (data[i] & 15) >> 2, data[i] & 3);
+            }
+            return i;
+        }
+    }
+    return -1;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (RunInput(data, size, true) >= 0) abort();
+    return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+
+static uint8_t input[MAX_INPUT];
+
+static double Seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static uint8_t RandomEvent(void) {
+    // Mostly presses, with fixes often enough for multi-tap to move
+    // on, and clear rare enough for texts to outgrow the screen.
+    int key;
+    do {
+        key = rand() % 16;
+    } while (key == 11 && rand() % 8);
+    int action = rand() % 16;
+    return action << 4 | key;
+}
+
+static size_t Load(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        perror(path);
+        exit(2);
+    }
+    size_t size = fread(input, 1, MAX_INPUT, file);
+    fclose(file);
+    return size;
+}
+
+static void Save(const char *path, const uint8_t *data, size_t size) {
+    FILE *file = fopen(path, "wb");
+    if (!file || fwrite(data, 1, size, file) != size) {
+        perror(path);
+        exit(2);
+    }
+    fclose(file);
+}
+
+static size_t Minimise(size_t size) {
+    // Removes ever smaller runs of events while the input still
+    // fails, then cuts it after its first mismatch.
+    static uint8_t candidate[MAX_INPUT];
+    int failed = RunInput(input, size, false);
+    if (failed < 0) return 0;
+    size = failed + 1;
+    for (size_t run = size / 2; run >= 1; run /= 2) {
+        for (size_t start = 0; start + run <= size;) {
+            memcpy(candidate, input, start);
+            memcpy(candidate + start, input + start + run,
+                   size - start - run);
+            failed = RunInput(candidate, size - run, false);
+            if (failed >= 0) {
+                size = failed + 1;
+                memcpy(input, candidate, size);
+            } else {
+                start += run;
+            }
+        }
+    }
+    return size;
+}
+
+int main(int argc, char **argv) {
+    long sequences = DEFAULT_SEQUENCES;
+    unsigned seed = 1;
+    int length = DEFAULT_LENGTH;
+    const char *minimise = NULL;
+    int i = 1;
+    for (; i + 1 < argc && argv[i][0] == '-'; i += 2) {
+        if (!strcmp(argv[i], "-n")) {
+            sequences = atol(argv[i + 1]);
+        } else if (!strcmp(argv[i], "-s")) {
+            seed = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "-l")) {
+            length = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "-m")) {
+            minimise = argv[i + 1];
+        } else {
+            break;
+        }
+    }
+    if ((i < argc && argv[i][0] == '-') || length < 1 ||
+        length > MAX_INPUT) {
+        fprintf(stderr, "usage: %s [-n sequences] [-s seed] [-l length]\n"
+                "       %s input...\n       %s -m input\n",
+                argv[0], argv[0], argv[0]);
+        return 2;
+    }
+
+    if (minimise) {
+        size_t size = Minimise(Load(minimise));
+        if (!size) {
+            printf("%s: no mismatch\n", minimise);
+            return 1;
+        }
+        char path[4096];
+        snprintf(path, sizeof(path), "%s.min", minimise);
+        Save(path, input, size);
+        printf("%s: %zu events\n", path, size);
+        RunInput(input, size, true);
+        return 0;
+    }
+
+    if (i < argc) {
+        int failures = 0;
+        for (; i < argc; ++i) {
+            size_t size = Load(argv[i]);
+            printf("%s: %zu events\n", argv[i], size);
+            failures += RunInput(input, size, true) >= 0;
+        }
+        return failures > 0;
+    }
+
+    srand(seed);
+    long events = 0;
+    double start = Seconds();
+    for (long n = 0; n < sequences; ++n) {
+        int size = 1 + rand() % length;
+        for (int k = 0; k < size; ++k) {
+            input[k] = RandomEvent();
+        }
+        events += size;
+        if (RunInput(input, size, false) >= 0) {
+            char path[64];
+            snprintf(path, sizeof(path), "failure-%u-%ld", seed, n);
+            Save(path, input, size);
+            printf("sequence %ld failed, written to %s\n", n, path);
+            RunInput(input, size, true);
+            return 1;
+        }
+    }
+    double seconds = Seconds() - start;
+    printf("%ld sequences, %ld events in %.2f s: %.0f sequences/s\n",
+           sequences, events, seconds, sequences / seconds);
+    return 0;
+}
+
+#endif
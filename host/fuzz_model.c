@@ -0,0 +1,486 @@
+#include <string.h>
+#include "fuzz_model.h"
+#include "lcd.h"
+#include "line_index.h"
+
+// The keypad layout, as in editor.c. The third press of 0 starts
+// a new line.
+static const char *const layout[4][4] = {
+    {"1", "abc2", "def3", ""},
+    {"ghi4", "jkl5", "mno6", ""},
+    {"prs7", "tuv8", "wxy9", ""},
+    {"*", " 0\n", "#", ""},
+};
+
+// Special keys and limits, as in editor.c.
+#define LEFT_KEY 0, 3
+#define BACKSPACE_KEY 1, 3
+#define CLEAR_KEY 2, 3
+#define RIGHT_KEY 3, 3
+#define NEXT_DOCUMENT_KEY 0, 0
+#define COPY_KEY 3, 2
+#define PASTE_KEY 3, 0
+#define REPEATS_BEFORE_WORD_STEP 6
+
+#define WIDTH LCD_TEXT_WIDTH
+#define HEIGHT LCD_TEXT_HEIGHT
+
+static bool Is(int row, int col, int key_row, int key_col) {
+    return row == key_row && col == key_col;
+}
+
+static int Newlines(const char *text, int length) {
+    int newlines = 0;
+    for (int i = 0; i < length; ++i) {
+        newlines += text[i] == '\n';
+    }
+    return newlines;
+}
+
+static bool LinesFit(const struct Model *model, int newlines) {
+    const struct ModelDocument *d = model->document;
+    return Newlines(d->text, d->length) + 1 + newlines <=
+           LINE_INDEX_MAX_LINES;
+}
+
+static int RowOf(const struct ModelDocument *d, int position, int *col) {
+    // A line of n characters takes n / WIDTH + 1 rows.
+    int row = 0;
+    int start = 0;
+    for (int i = 0; i < position; ++i) {
+        if (d->text[i] == '\n') {
+            row += (i - start) / WIDTH + 1;
+            start = i + 1;
+        }
+    }
+    *col = (position - start) % WIDTH;
+    return row + (position - start) / WIDTH;
+}
+
+static int Rows(const struct Model *model) {
+    return model->searching ? HEIGHT - 1 : HEIGHT;
+}
+
+static void Synchronise(struct Model *model) {
+    // Scrolls as little as keeps the cursor on the screen.
+    struct ModelDocument *d = model->document;
+    int col;
+    int row = RowOf(d, d->cursor, &col);
+    if (row < d->viewport_row) {
+        d->viewport_row = row;
+    } else if (row >= d->viewport_row + Rows(model)) {
+        d->viewport_row = row - Rows(model) + 1;
+    }
+}
+
+static void Insert(struct ModelDocument *d, int position, const char *text,
+                   int count) {
+    memmove(d->text + position + count, d->text + position,
+            d->length - position);
+    memcpy(d->text + position, text, count);
+    d->length += count;
+}
+
+static void Delete(struct ModelDocument *d, int position, int count) {
+    memmove(d->text + position, d->text + position + count,
+            d->length - position - count);
+    d->length -= count;
+}
+
+static int SelectionFrom(const struct Model *model) {
+    int cursor = model->document->cursor;
+    return model->anchor < cursor ? model->anchor : cursor;
+}
+
+static int SelectionTo(const struct Model *model) {
+    int cursor = model->document->cursor;
+    return model->anchor < cursor ? cursor : model->anchor;
+}
+
+static bool IsSpace(char c) {
+    return c == ' ' || c == '\n';
+}
+
+static int PreviousWordStart(const struct ModelDocument *d, int position) {
+    while (position > 0 && IsSpace(d->text[position - 1])) --position;
+    while (position > 0 && !IsSpace(d->text[position - 1])) --position;
+    return position;
+}
+
+static int NextWordStart(const struct ModelDocument *d, int position) {
+    while (position < d->length && !IsSpace(d->text[position])) ++position;
+    while (position < d->length && IsSpace(d->text[position])) ++position;
+    return position;
+}
+
+// Buffer operations.
+
+static void BufferReplaceChar(struct Model *model, char c) {
+    struct ModelDocument *d = model->document;
+    int position = d->cursor - 1;
+    if (position >= 0 &&
+        (d->text[position] == '\n' || c != '\n' || LinesFit(model, 1))) {
+        d->text[position] = c;
+    }
+    Synchronise(model);
+}
+
+static void BufferClear(struct Model *model) {
+    struct ModelDocument *d = model->document;
+    d->length = 0;
+    d->cursor = 0;
+    d->viewport_row = 0;
+    model->selecting = false;
+    Synchronise(model);
+}
+
+static void BufferDeleteBackward(struct Model *model, int count) {
+    struct ModelDocument *d = model->document;
+    if (count > d->cursor) count = d->cursor;
+    if (count <= 0) return;
+    Delete(d, d->cursor - count, count);
+    d->cursor -= count;
+    Synchronise(model);
+}
+
+static void BufferAdd(struct Model *model, char c) {
+    struct ModelDocument *d = model->document;
+    if (c != '\n' || LinesFit(model, 1)) {
+        Insert(d, d->cursor, &c, 1);
+        ++d->cursor;
+    }
+    Synchronise(model);
+}
+
+static void BufferMoveTo(struct Model *model, int position) {
+    struct ModelDocument *d = model->document;
+    if (position < 0) position = 0;
+    if (position > d->length) position = d->length;
+    d->cursor = position;
+    Synchronise(model);
+}
+
+static void BufferPaste(struct Model *model) {
+    struct ModelDocument *d = model->document;
+    if (LinesFit(model, Newlines(model->clipboard,
+                                 model->clipboard_length))) {
+        Insert(d, d->cursor, model->clipboard, model->clipboard_length);
+        d->cursor += model->clipboard_length;
+    }
+    Synchronise(model);
+}
+
+static void DocumentSwitch(struct Model *model, int slot) {
+    model->current = slot;
+    model->document = &model->documents[slot];
+    model->selecting = false;
+    Synchronise(model);
+}
+
+// Selection mode.
+
+static void SelectionBegin(struct Model *model) {
+    model->selecting = true;
+    model->anchor = model->document->cursor;
+    Synchronise(model);
+}
+
+static void SelectionCopy(struct Model *model) {
+    int from = SelectionFrom(model);
+    model->clipboard_length = SelectionTo(model) - from;
+    memcpy(model->clipboard, model->document->text + from,
+           model->clipboard_length);
+}
+
+static void SelectionDelete(struct Model *model) {
+    int from = SelectionFrom(model);
+    Delete(model->document, from, SelectionTo(model) - from);
+    model->document->cursor = from;
+    model->anchor = from;
+}
+
+static void SelectionEnd(struct Model *model) {
+    model->selecting = false;
+    Synchronise(model);
+}
+
+static void SelectionButtonPressed(struct Model *model, int row, int col) {
+    if (Is(row, col, LEFT_KEY)) {
+        BufferMoveTo(model, model->document->cursor - 1);
+        model->press_repeats = true;
+    } else if (Is(row, col, RIGHT_KEY)) {
+        BufferMoveTo(model, model->document->cursor + 1);
+        model->press_repeats = true;
+    } else if (Is(row, col, COPY_KEY)) {
+        SelectionCopy(model);
+        SelectionEnd(model);
+    } else if (Is(row, col, BACKSPACE_KEY)) {
+        SelectionCopy(model);
+        SelectionDelete(model);
+        SelectionEnd(model);
+    } else if (Is(row, col, PASTE_KEY)) {
+        SelectionDelete(model);
+        model->selecting = false;
+        BufferPaste(model);
+    } else if (Is(row, col, CLEAR_KEY)) {
+        SelectionEnd(model);
+    }
+}
+
+// Search mode. Each prefix of the query is looked for from where
+// the one before it was found, wrapping around the end of the text.
+
+static int FindWrapping(const struct Model *model, int length, int from) {
+    const struct ModelDocument *d = model->document;
+    for (int p = from; p + length <= d->length; ++p) {
+        if (!memcmp(d->text + p, model->query, length)) return p;
+    }
+    for (int p = 0; p < from && p + length <= d->length; ++p) {
+        if (!memcmp(d->text + p, model->query, length)) return p;
+    }
+    return -1;
+}
+
+static int MatchFound(const struct Model *model, int *length) {
+    int k = model->query_length;
+    while (k > 0 && model->matches[k - 1] < 0) --k;
+    *length = k;
+    return k ? model->matches[k - 1] : model->search_from;
+}
+
+static void SearchFollow(struct Model *model) {
+    int length;
+    model->document->cursor = MatchFound(model, &length);
+    Synchronise(model);
+}
+
+static void SearchBegin(struct Model *model) {
+    model->searching = true;
+    model->query_length = 0;
+    model->search_from = model->document->cursor;
+    Synchronise(model);
+}
+
+static void SearchAdd(struct Model *model, char c) {
+    int k = model->query_length;
+    if (k == SEARCH_MAX_QUERY) return;
+    int from = k ? model->matches[k - 1] : model->search_from;
+    model->query[k] = c;
+    model->query_length = k + 1;
+    model->matches[k] = from < 0 ? -1 : FindWrapping(model, k + 1, from);
+    SearchFollow(model);
+}
+
+static void SearchReplaceChar(struct Model *model, char c) {
+    if (model->query_length > 0) --model->query_length;
+    SearchAdd(model, c);
+}
+
+static void SearchEnd(struct Model *model) {
+    model->searching = false;
+    Synchronise(model);
+}
+
+static void SearchButtonPressed(struct Model *model, int row, int col) {
+    int k = model->query_length;
+    if (Is(row, col, RIGHT_KEY)) {
+        if (k > 0 && model->matches[k - 1] >= 0) {
+            model->matches[k - 1] =
+                FindWrapping(model, k, model->matches[k - 1] + 1);
+        }
+        SearchFollow(model);
+    } else if (Is(row, col, BACKSPACE_KEY)) {
+        if (k > 0) --model->query_length;
+        SearchFollow(model);
+    } else if (Is(row, col, CLEAR_KEY)) {
+        SearchEnd(model);
+    }
+}
+
+// Keys.
+
+static void InputAdd(struct Model *model, char c) {
+    if (model->searching) {
+        SearchAdd(model, c);
+    } else {
+        BufferAdd(model, c);
+    }
+}
+
+static void ButtonRepeat(struct Model *model) {
+    const char *choices = layout[model->temporary_row][model->temporary_col];
+    if (!choices[++model->choice]) model->choice = 0;
+    if (model->searching) {
+        SearchReplaceChar(model, choices[model->choice]);
+    } else {
+        BufferReplaceChar(model, choices[model->choice]);
+    }
+}
+
+void ModelReset(struct Model *model) {
+    memset(model, 0, sizeof(*model));
+    model->document = &model->documents[0];
+    model->temporary_row = -1;
+    model->temporary_col = -1;
+}
+
+bool ModelPressOverflows(const struct Model *model, int row, int col) {
+    const struct ModelDocument *d = model->document;
+    if (model->selecting) {
+        return Is(row, col, PASTE_KEY) &&
+               d->length - (SelectionTo(model) - SelectionFrom(model)) +
+               model->clipboard_length > MODEL_MAX_TEXT;
+    }
+    return !model->searching && *layout[row][col] &&
+           d->length + 1 > MODEL_MAX_TEXT;
+}
+
+void ModelPressed(struct Model *model, int row, int col) {
+    model->press_repeats = false;
+    model->press_added_char = false;
+    if (model->temporary_row == row && model->temporary_col == col) {
+        ButtonRepeat(model);
+        return;
+    }
+    model->temporary_row = -1;
+    model->temporary_col = -1;
+    model->choice = 0;
+    const char *choices = layout[row][col];
+    if (model->selecting) {
+        SelectionButtonPressed(model, row, col);
+    } else if (model->searching && !*choices) {
+        SearchButtonPressed(model, row, col);
+    } else if (Is(row, col, LEFT_KEY)) {
+        BufferMoveTo(model, model->document->cursor - 1);
+        model->press_repeats = true;
+    } else if (Is(row, col, CLEAR_KEY)) {
+        BufferClear(model);
+    } else if (Is(row, col, BACKSPACE_KEY)) {
+        BufferDeleteBackward(model, 1);
+        model->press_repeats = true;
+    } else if (Is(row, col, RIGHT_KEY)) {
+        BufferMoveTo(model, model->document->cursor + 1);
+        model->press_repeats = true;
+    } else if (!model->searching ||
+               model->query_length < SEARCH_MAX_QUERY) {
+        if (*choices && choices[1]) {
+            model->temporary_row = row;
+            model->temporary_col = col;
+            InputAdd(model, *choices);
+        } else if (*choices) {
+            InputAdd(model, *choices);
+            model->press_added_char = !model->searching;
+        }
+    }
+}
+
+void ModelHeld(struct Model *model, int row, int col, int repeat) {
+    // A long press takes back the character of '#', '1' or '*'.
+    struct ModelDocument *d = model->document;
+    if (model->press_added_char && repeat == 0) {
+        if (Is(row, col, COPY_KEY)) {
+            BufferDeleteBackward(model, 1);
+            SelectionBegin(model);
+            return;
+        }
+        if (Is(row, col, NEXT_DOCUMENT_KEY)) {
+            BufferDeleteBackward(model, 1);
+            DocumentSwitch(model, (model->current + 1) % DOCUMENT_SLOTS);
+            return;
+        }
+        if (Is(row, col, PASTE_KEY)) {
+            BufferDeleteBackward(model, 1);
+            SearchBegin(model);
+            return;
+        }
+    }
+    if (!model->press_repeats) return;
+    bool by_word = repeat >= REPEATS_BEFORE_WORD_STEP;
+    if (Is(row, col, LEFT_KEY)) {
+        BufferMoveTo(model, by_word ? PreviousWordStart(d, d->cursor)
+                                    : d->cursor - 1);
+    } else if (Is(row, col, BACKSPACE_KEY)) {
+        BufferDeleteBackward(model, by_word
+            ? d->cursor - PreviousWordStart(d, d->cursor) : 1);
+    } else if (Is(row, col, RIGHT_KEY)) {
+        BufferMoveTo(model, by_word ? NextWordStart(d, d->cursor)
+                                    : d->cursor + 1);
+    }
+}
+
+void ModelFix(struct Model *model) {
+    if (model->temporary_row == -1) return;
+    model->temporary_row = -1;
+    model->temporary_col = -1;
+    Synchronise(model);
+}
+
+// The screen.
+
+static struct ScreenCell Cell(char c, uint16_t text, uint16_t back) {
+    struct ScreenCell cell = {c, text, back, false, false};
+    // Characters without a glyph show as spaces.
+    if (c < ' ' || c > '~') cell.c = ' ';
+    return cell;
+}
+
+static struct ScreenCell CursorCell(const struct Model *model, char c) {
+    // Blue on white, on yellow after a temporary character.
+    return Cell(c, LCD_COLOR_BLUE, model->temporary_row != -1
+                                   ? LCD_COLOR_YELLOW : LCD_COLOR_WHITE);
+}
+
+void ModelScreen(const struct Model *model, Screen screen) {
+    const struct ModelDocument *d = model->document;
+    int rows = Rows(model);
+    for (int i = 0; i < HEIGHT; ++i) {
+        for (int j = 0; j < WIDTH; ++j) {
+            screen[i][j] = Cell(' ', LCD_COLOR_WHITE, LCD_COLOR_BLUE);
+        }
+    }
+
+    // Every position of the text, the newlines and its end included,
+    // has a cell: the next one in its line, or the start of the next
+    // line after a newline.
+    int match_length = 0;
+    int match = model->searching ? MatchFound(model, &match_length) : 0;
+    int row = 0;
+    int col = 0;
+    for (int p = 0; p <= d->length; ++p) {
+        int i = row - d->viewport_row;
+        if (i >= 0 && i < rows) {
+            char c = p < d->length && d->text[p] != '\n' ? d->text[p] : ' ';
+            struct ScreenCell *cell = &screen[i][col];
+            if (p >= match && p < match + match_length) {
+                *cell = Cell(c, LCD_COLOR_BLACK, LCD_COLOR_GREEN);
+            } else if (!model->searching && p == d->cursor) {
+                *cell = CursorCell(model, c);
+            } else if (model->selecting && p >= SelectionFrom(model) &&
+                       p < SelectionTo(model)) {
+                *cell = Cell(c, LCD_COLOR_WHITE, LCD_COLOR_BLACK);
+            } else {
+                *cell = Cell(c, LCD_COLOR_WHITE, LCD_COLOR_BLUE);
+            }
+        }
+        if ((p < d->length && d->text[p] == '\n') || ++col == WIDTH) {
+            ++row;
+            col = 0;
+        }
+    }
+
+    // The query on the last row: '?', or '!' if it was not found, its
+    // end and the cursor.
+    if (model->searching) {
+        struct ScreenCell *query = screen[HEIGHT - 1];
+        int found;
+        MatchFound(model, &found);
+        query[0].c = found == model->query_length ? '?' : '!';
+        int shown = model->query_length < WIDTH - 2 ? model->query_length
+                                                     : WIDTH - 2;
+        for (int i = 0; i < shown; ++i) {
+            query[1 + i] = Cell(model->query[model->query_length - shown + i],
+                                LCD_COLOR_WHITE, LCD_COLOR_BLUE);
+        }
+        query[1 + shown] = CursorCell(model, ' ');
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef _FUZZ_MODEL_H
+#define _FUZZ_MODEL_H 1
+
+#include <stdbool.h>
+#include "editor.h"
+#include "screen.h"
+#include "text_search.h"
+
+// A reference model of the editor for fuzz.c: the behaviour of
+// editor.c on plain character arrays, with the layout, the search
+// and the screen computed from scratch by the simplest means.
+//
+// The text is kept within MODEL_MAX_TEXT characters, far from where
+// the chunk pool and the pieces of editor.c run out, so that every
+// edit the model makes fits in the firmware too.
+#define MODEL_MAX_TEXT 4096
+
+struct ModelDocument {
+    char text[MODEL_MAX_TEXT];
+    int length;
+    int cursor;
+    int viewport_row;
+};
+
+struct Model {
+    struct ModelDocument documents[DOCUMENT_SLOTS];
+    struct ModelDocument *document;
+    int current;
+    char clipboard[MODEL_MAX_TEXT];
+    int clipboard_length;
+    bool selecting;
+    int anchor;
+    bool searching;
+    char query[SEARCH_MAX_QUERY];
+    int query_length;
+    // Where each prefix of the query was found, or -1.
+    int matches[SEARCH_MAX_QUERY];
+    int search_from;
+    // The multi-tap key and its choice, row -1 if none.
+    int temporary_row;
+    int temporary_col;
+    int choice;
+    bool press_repeats;
+    bool press_added_char;
+};
+
+void ModelReset(struct Model *model);
+// Whether pressing the key could take the text past MODEL_MAX_TEXT.
+bool ModelPressOverflows(const struct Model *model, int row, int col);
+
+// The keyboard.h callbacks.
+void ModelPressed(struct Model *model, int row, int col);
+void ModelHeld(struct Model *model, int row, int col, int repeat);
+void ModelFix(struct Model *model);
+
+// What the LCD should show.
+void ModelScreen(const struct Model *model, Screen screen);
+
+#endif
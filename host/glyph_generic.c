@@ -0,0 +1,13 @@
+// lcd.c with the glyph kernel it had before unrolling, its interface
+// renamed so that glyphbench.c links it next to lcd.c.
+#define LCD_GENERIC_KERNEL
+#define LCDsetRectangle GenericLCDsetRectangle
+#define LCDconfigure GenericLCDconfigure
+#define LCDclear GenericLCDclear
+#define LCDgoto GenericLCDgoto
+#define LCDputchar GenericLCDputchar
+#define LCDputcharWrap GenericLCDputcharWrap
+#define LCDbackspace GenericLCDbackspace
+#define LCDputchars GenericLCDputchars
+#define LCDunderline GenericLCDunderline
+#include "lcd.c"
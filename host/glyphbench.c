@@ -0,0 +1,176 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include <fonts.h>
+#include <stm32.h>
+#include "lcd.h"
+#include "lcd_geometry.h"
+
+// Times the glyph kernel of lcd.c, unrolled for the font size with
+// LCD_REPEAT, against the loop over the glyph size of the font it
+// replaced, built from the same lcd.c by glyph_generic.c.
+//
+//   glyphbench [-n glyphs] [-r runs]
+//
+// Both draw the same glyphs over the whole grid, one at a time with
+// LCDputchar and a row at a time with LCDputchars, and must write
+// the same pins in the same order. The ports are plain memory here
+// rather than hardware.c, whose decoding of the serial line would
+// take most of the time, and their writes are hashed in a run of
+// their own, not while timing. Cycles are host cycles, the best of
+// the runs, and include the bit-banged serial output of lcd.c,
+// three port writes per bit, as on the board.
+
+#define DEFAULT_GLYPHS 5000
+#define DEFAULT_RUNS 5
+
+void GenericLCDconfigure(void);
+void GenericLCDgoto(int textLine, int charPos);
+void GenericLCDputchar(char c);
+void GenericLCDputchars(const char *s, int count, uint16_t text,
+                        uint16_t back, int underline);
+
+struct Kernel {
+    const char *name;
+    void (*configure)(void);
+    void (*go)(int line, int position);
+    void (*putchar)(char c);
+    void (*putchars)(const char *s, int count, uint16_t text,
+                     uint16_t back, int underline);
+};
+
+static const struct Kernel kernels[2] = {
+    {"unrolled", LCDconfigure, LCDgoto, LCDputchar, LCDputchars},
+    {"generic", GenericLCDconfigure, GenericLCDgoto, GenericLCDputchar,
+     GenericLCDputchars},
+};
+
+// The stand-in for the ports and the font, see stubs/stm32.h.
+RCC_TypeDef host_rcc;
+EXTI_TypeDef host_exti;
+TIM_TypeDef host_tim3;
+static GPIO_TypeDef ports[3];
+static bool hashing;
+static uint64_t pin_hash;
+
+static uint16_t font_table[(LAST_CHAR - FIRST_CHAR + 1) * LCD_FONT_HEIGHT];
+const font_t host_font = {font_table, LCD_FONT_WIDTH, LCD_FONT_HEIGHT};
+
+GPIO_TypeDef *HostGpio(int port) {
+    // Hashes the set and reset of every port written since the
+    // last access, when not timing.
+    if (!hashing) return &ports[port];
+    for (int p = 0; p < 3; ++p) {
+        uint32_t write = ports[p].BSRRL | (uint32_t) ports[p].BSRRH << 16;
+        if (!write) continue;
+        pin_hash = (pin_hash ^ write ^ (uint64_t) p << 32) *
+                   1099511628211ULL;
+        ports[p].BSRRL = 0;
+        ports[p].BSRRH = 0;
+    }
+    return &ports[port];
+}
+
+static uint64_t Cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+static char Glyph(long g) {
+    return ' ' + g % ('~' - ' ' + 1);
+}
+
+static uint64_t Single(const struct Kernel *kernel, long glyphs) {
+    uint64_t start = Cycles();
+    for (long g = 0; g < glyphs; ++g) {
+        int cell = g % (LCD_TEXT_WIDTH * LCD_TEXT_HEIGHT);
+        kernel->go(cell / LCD_TEXT_WIDTH, cell % LCD_TEXT_WIDTH);
+        kernel->putchar(Glyph(g));
+    }
+    return Cycles() - start;
+}
+
+static uint64_t Rows(const struct Kernel *kernel, long glyphs) {
+    char row[LCD_TEXT_WIDTH];
+    uint64_t start = Cycles();
+    for (long g = 0; g < glyphs; g += LCD_TEXT_WIDTH) {
+        for (int i = 0; i < LCD_TEXT_WIDTH; ++i) {
+            row[i] = Glyph(g + i);
+        }
+        kernel->go(g / LCD_TEXT_WIDTH % LCD_TEXT_HEIGHT, 0);
+        kernel->putchars(row, LCD_TEXT_WIDTH, LCD_COLOR_WHITE,
+                         LCD_COLOR_BLUE, g % 2);
+    }
+    return Cycles() - start;
+}
+
+int main(int argc, char **argv) {
+    long glyphs = DEFAULT_GLYPHS;
+    int runs = DEFAULT_RUNS;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 < argc && !strcmp(argv[i], "-n")) {
+            glyphs = atol(argv[i + 1]);
+        } else if (i + 1 < argc && !strcmp(argv[i], "-r")) {
+            runs = atoi(argv[i + 1]);
+        } else {
+            fprintf(stderr, "usage: %s [-n glyphs] [-r runs]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (glyphs < LCD_TEXT_WIDTH || runs < 1) {
+        fprintf(stderr, "%s: at least %d glyphs and a run\n", argv[0],
+                LCD_TEXT_WIDTH);
+        return 2;
+    }
+    // Whole rows for LCDputchars.
+    glyphs -= glyphs % LCD_TEXT_WIDTH;
+
+    // Any glyphs will do, as long as they differ.
+    for (unsigned i = 0; i < sizeof(font_table) / sizeof(*font_table); ++i) {
+        font_table[i] = (i * 2654435761U) >> 16;
+    }
+    uint64_t hashes[2];
+    printf("%ld glyphs of %dx%d, best of %d runs\n", glyphs, LCD_FONT_WIDTH,
+           LCD_FONT_HEIGHT, runs);
+    printf("  %-10s %16s %16s\n", "", "LCDputchar", "LCDputchars");
+    for (int k = 0; k < 2; ++k) {
+        kernels[k].configure();
+        uint64_t best[2] = {UINT64_MAX, UINT64_MAX};
+        for (int run = 0; run < runs; ++run) {
+            uint64_t single = Single(&kernels[k], glyphs);
+            uint64_t rows = Rows(&kernels[k], glyphs);
+            if (single < best[0]) best[0] = single;
+            if (rows < best[1]) best[1] = rows;
+        }
+        hashing = true;
+        pin_hash = 0;
+        Single(&kernels[k], glyphs);
+        Rows(&kernels[k], glyphs);
+        HostGpio(0);
+        hashes[k] = pin_hash;
+        hashing = false;
+        printf("  %-10s %9llu cycles %9llu cycles per glyph\n",
+               kernels[k].name,
+               (unsigned long long) (best[0] / glyphs),
+               (unsigned long long) (best[1] / glyphs));
+    }
+    if (hashes[0] != hashes[1]) {
+        fprintf(stderr, "the kernels wrote different pins: %016llx, "
+                "%016llx\n", (unsigned long long) hashes[0],
+                (unsigned long long) hashes[1]);
+        return 1;
+    }
+    printf("  same pin writes, hash %016llx\n",
+           (unsigned long long) hashes[0]);
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include <stm32.h>
+#include <fonts.h>
+#include <lcd_board_def.h>
+#include "hardware.h"
+#include "lcd_geometry.h"
+
+#define HOST_PORT_A 0
+#define HOST_PORT_B 1
+#define HOST_PORT_C 2
+#define PORT_COUNT 3
+#define PORT_OF(letter) xcat(HOST_PORT_, letter)
+
+#define CS_PORT  PORT_OF(LCD_CS_GPIO_N)
+#define A0_PORT  PORT_OF(LCD_A0_GPIO_N)
+#define SDA_PORT PORT_OF(LCD_SDA_GPIO_N)
+#define SCK_PORT PORT_OF(LCD_SCK_GPIO_N)
+
+// The keyboard drives columns on pins 0-3 of port C and reads rows,
+// pulled up, on pins 6-9.
+#define KEYPAD_PORT HOST_PORT_C
+#define ROW_PIN(row) ((row) + 6)
+#define ROW_PINS (0xfU << 6)
+
+// ST7735 commands.
+#define COMMAND_COLUMN_ADDRESS 0x2A
+#define COMMAND_ROW_ADDRESS    0x2B
+#define COMMAND_MEMORY_WRITE   0x2C
+
+#define TIMER_PERIOD_MS 10
+
+RCC_TypeDef host_rcc;
+EXTI_TypeDef host_exti;
+TIM_TypeDef host_tim3;
+struct LcdCounters lcd_counters;
+uint16_t lcd_frame[LCD_PIXEL_HEIGHT][LCD_PIXEL_WIDTH];
+
+static GPIO_TypeDef ports[PORT_COUNT];
+static uint32_t outputs[PORT_COUNT];
+static bool keys[4][4];
+// The port last handed out, the only one with a write pending.
+static int pending_port = -1;
+
+// Serial bits collected into the current byte.
+static uint32_t serial_byte;
+static int serial_bits;
+// The last command and the data bytes sent after it. Data after
+// a memory write command is pixels, two bytes each, filling the
+// window row by row.
+static uint32_t command;
+static uint32_t data;
+static int data_bytes;
+static int window_x1, window_x2, window_y1, window_y2;
+static int write_x, write_y;
+
+static uint16_t font_table[(LAST_CHAR - FIRST_CHAR + 1) * LCD_FONT_HEIGHT];
+const font_t host_font = {font_table, LCD_FONT_WIDTH, LCD_FONT_HEIGHT};
+
+static bool Pin(int port, int pin) {
+    return outputs[port] >> pin & 1;
+}
+
+static void SerialData(uint32_t byte) {
+    data = data << 8 | byte;
+    ++data_bytes;
+    if (command == COMMAND_COLUMN_ADDRESS && data_bytes == 4) {
+        window_x1 = data >> 16;
+        window_x2 = data & 0xFFFF;
+    } else if (command == COMMAND_ROW_ADDRESS && data_bytes == 4) {
+        window_y1 = data >> 16;
+        window_y2 = data & 0xFFFF;
+    } else if (command == COMMAND_MEMORY_WRITE && data_bytes % 2 == 0) {
+        ++lcd_counters.pixels;
+        if (write_x < LCD_PIXEL_WIDTH && write_y < LCD_PIXEL_HEIGHT) {
+            lcd_frame[write_y][write_x] = data;
+        }
+        if (++write_x > window_x2) {
+            write_x = window_x1;
+            if (++write_y > window_y2) write_y = window_y1;
+        }
+    }
+}
+
+static void SerialByte(uint32_t byte) {
+    bool is_data = Pin(A0_PORT, LCD_A0_PIN_N);
+    lcd_counters.hash = (lcd_counters.hash ^ byte ^ !is_data << 8)
+                        * 1099511628211ULL;
+    if (is_data) {
+        SerialData(byte);
+        return;
+    }
+    command = byte;
+    data = 0;
+    data_bytes = 0;
+    write_x = window_x1;
+    write_y = window_y1;
+    ++lcd_counters.commands;
+    if (byte == COMMAND_COLUMN_ADDRESS) ++lcd_counters.windows;
+    if (byte == COMMAND_MEMORY_WRITE) {
+        // A window a glyph high and whole glyphs wide is a run of
+        // glyphs, lcd.c fills it. Underlines are a pixel high and
+        // clears the whole screen.
+        int width = window_x2 - window_x1 + 1;
+        if (window_y2 - window_y1 + 1 == LCD_FONT_HEIGHT &&
+            width % LCD_FONT_WIDTH == 0) {
+            lcd_counters.glyphs += width / LCD_FONT_WIDTH;
+        }
+    }
+}
+
+static void Apply(int port) {
+    // Set has priority over reset, as in BSRR.
+    GPIO_TypeDef *gpio = &ports[port];
+    bool clock = Pin(SCK_PORT, LCD_SCK_PIN_N);
+    outputs[port] = (outputs[port] & ~gpio->BSRRH) | gpio->BSRRL;
+    gpio->BSRRL = 0;
+    gpio->BSRRH = 0;
+    // The LCD reads a bit on a rising clock edge while selected.
+    if (port == SCK_PORT && !clock && Pin(SCK_PORT, LCD_SCK_PIN_N) &&
+        !Pin(CS_PORT, LCD_CS_PIN_N)) {
+        ++lcd_counters.spi_bits;
+        serial_byte = serial_byte << 1 | Pin(SDA_PORT, LCD_SDA_PIN_N);
+        if (++serial_bits == 8) {
+            SerialByte(serial_byte);
+            serial_byte = 0;
+            serial_bits = 0;
+        }
+    }
+}
+
+static uint32_t KeypadRows(void) {
+    // A row reads low if a pressed key connects it to a low column.
+    uint32_t rows = ROW_PINS;
+    for (int row = 0; row < 4; ++row) {
+        for (int col = 0; col < 4; ++col) {
+            if (keys[row][col] && !Pin(KEYPAD_PORT, col)) {
+                rows &= ~(1U << ROW_PIN(row));
+            }
+        }
+    }
+    return rows;
+}
+
+void HostGpioFlush(void) {
+    if (pending_port >= 0) {
+        Apply(pending_port);
+    }
+}
+
+GPIO_TypeDef *HostGpio(int port) {
+    HostGpioFlush();
+    pending_port = port;
+    if (port == KEYPAD_PORT) {
+        ports[KEYPAD_PORT].IDR = KeypadRows();
+    }
+    return &ports[port];
+}
+
+void HostHardwareConfigure(void) {
+    // Any glyphs will do, as long as they differ.
+    for (unsigned i = 0; i < sizeof(font_table) / sizeof(*font_table); ++i) {
+        font_table[i] = (i * 2654435761U) >> 16;
+    }
+    outputs[CS_PORT] |= 1U << LCD_CS_PIN_N;
+}
+
+void HostKeySet(int row, int col, bool pressed) {
+    keys[row][col] = pressed;
+}
+
+bool HostTimerStep(void) {
+    if (!(host_tim3.CR1 & TIM_CR1_CEN)) return false;
+    if (++host_tim3.CNT < TIMER_PERIOD_MS) return false;
+    host_tim3.CNT = 0;
+    host_tim3.SR |= TIM_SR_UIF;
+    return true;
+}
+
+bool HostRowInterruptPending(void) {
+    HostGpioFlush();
+    return (~KeypadRows() & host_exti.IMR & ROW_PINS) != 0;
+}
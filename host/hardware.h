@@ -0,0 +1,47 @@
+#ifndef _HARDWARE_H
+#define _HARDWARE_H 1
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lcd_geometry.h"
+
+// Stand-in hardware for replaying on the host: the keypad matrix
+// seen by keyboard.c and the LCD serial line driven by lcd.c.
+
+// What has been sent to the LCD. Bytes are decoded from the pin
+// changes of its serial line.
+struct LcdCounters {
+    uint64_t spi_bits;
+    uint64_t commands;
+    // Column address commands, one per window set by
+    // LCDsetRectangle.
+    uint64_t windows;
+    // Glyphs drawn, counted from the windows of memory writes.
+    uint64_t glyphs;
+    uint64_t pixels;
+    // Of all bytes sent, tells whether two runs drew the same.
+    uint64_t hash;
+};
+
+extern struct LcdCounters lcd_counters;
+// What the LCD shows, by the addresses of the controller.
+extern uint16_t lcd_frame[LCD_PIXEL_HEIGHT][LCD_PIXEL_WIDTH];
+
+void HostHardwareConfigure(void);
+void HostKeySet(int row, int col, bool pressed);
+// Applies the last pin write, which is otherwise applied
+// on the next port access.
+void HostGpioFlush(void);
+// Advances the timer by a millisecond. Returns true when it
+// overflows, which is when TIM3_IRQHandler is due.
+bool HostTimerStep(void);
+// True if a row line is low while its interrupt is enabled.
+// Checked right after a press, it tells whether the falling edge
+// raised EXTI9_5_IRQHandler.
+bool HostRowInterruptPending(void);
+
+// Interrupt handlers of keyboard.c.
+void TIM3_IRQHandler(void);
+void EXTI9_5_IRQHandler(void);
+
+#endif
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lcd_geometry.h"
+#include "line_index.h"
+
+// Times the line index of the editor on a long document with many
+// short lines, against mapping positions to rows by scanning the
+// text from its start.
+//
+//   linebench [-n edits] [-s seed]
+//
+// The document is 32 KB of lines of 4 to 36 characters, with the
+// screen width of lcd_geometry.h. Each edit inserts or deletes a
+// character, a tenth of them newlines, near a cursor that wanders
+// off by a few characters per edit and jumps once in a while. After
+// each edit the cursor is mapped to its row and the rows of a screen
+// around it to their text, as SynchroniseViewport does. Every
+// hundredth edit the scan does the same and the results are
+// compared.
+
+#define DOCUMENT_SIZE 32768
+#define MIN_LINE 4
+#define MAX_LINE 36
+#define DEFAULT_EDITS 200000
+#define SCAN_EVERY 100
+
+static char text[DOCUMENT_SIZE * 2];
+static int length;
+static struct LineIndex lines;
+
+static double Seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static int ScanRowOf(int position, int *col) {
+    int row = 0;
+    int start = 0;
+    for (int i = 0; i < position; ++i) {
+        if (text[i] == '\n') {
+            row += (i - start) / LCD_TEXT_WIDTH + 1;
+            start = i + 1;
+        }
+    }
+    *col = (position - start) % LCD_TEXT_WIDTH;
+    return row + (position - start) / LCD_TEXT_WIDTH;
+}
+
+static int ScanRowStart(int row, int *row_length) {
+    int first = 0;
+    int start = 0;
+    for (int i = 0; i <= length; ++i) {
+        if (i < length && text[i] != '\n') continue;
+        int rows = (i - start) / LCD_TEXT_WIDTH + 1;
+        if (row < first + rows) {
+            int offset = (row - first) * LCD_TEXT_WIDTH;
+            int rest = i - start - offset;
+            *row_length = rest < LCD_TEXT_WIDTH ? rest : LCD_TEXT_WIDTH;
+            return start + offset;
+        }
+        first += rows;
+        start = i + 1;
+    }
+    *row_length = 0;
+    return -1;
+}
+
+static void Generate(void) {
+    length = 0;
+    while (length < DOCUMENT_SIZE) {
+        int line = MIN_LINE + rand() % (MAX_LINE - MIN_LINE + 1);
+        for (int i = 0; i < line && length < DOCUMENT_SIZE - 1; ++i) {
+            text[length++] = rand() % 6 ? 'a' + rand() % 26 : ' ';
+        }
+        text[length++] = '\n';
+    }
+}
+
+static void Report(const char *name, double seconds, long count) {
+    printf("  %-22s %10.1f ns\n", name, seconds * 1e9 / count);
+}
+
+int main(int argc, char **argv) {
+    long edits = DEFAULT_EDITS;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 < argc && !strcmp(argv[i], "-n")) {
+            edits = atol(argv[i + 1]);
+        } else if (i + 1 < argc && !strcmp(argv[i], "-s")) {
+            seed = atoi(argv[i + 1]);
+        } else {
+            fprintf(stderr, "usage: %s [-n edits] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+    srand(seed);
+    Generate();
+
+    double start = Seconds();
+    LineIndexClear(&lines, LCD_TEXT_WIDTH);
+    LineIndexInsert(&lines, 0, text, length);
+    double build = Seconds() - start;
+    printf("%d characters, %d lines, %d rows of %d\n", length,
+           LineIndexLineCount(&lines), LineIndexRowCount(&lines),
+           LCD_TEXT_WIDTH);
+
+    double edit_time = 0;
+    double map_time = 0;
+    double scan_time = 0;
+    long scans = 0;
+    int cursor = length / 2;
+    for (long e = 0; e < edits; ++e) {
+        if (rand() % 1000 == 0) {
+            cursor = rand() % (length + 1);
+        } else {
+            cursor += rand() % 7 - 3;
+            if (cursor < 0) cursor = 0;
+            if (cursor > length) cursor = length;
+        }
+        if ((rand() % 2 || cursor == length) && length < (int) sizeof(text)) {
+            char c = rand() % 10 ? 'a' : '\n';
+            if (c == '\n' && !LineIndexCanInsert(&lines, 1)) c = 'a';
+            memmove(text + cursor + 1, text + cursor, length - cursor);
+            text[cursor] = c;
+            ++length;
+            start = Seconds();
+            LineIndexInsert(&lines, cursor, &c, 1);
+        } else {
+            memmove(text + cursor, text + cursor + 1, length - cursor - 1);
+            --length;
+            start = Seconds();
+            LineIndexDelete(&lines, cursor, 1);
+        }
+        edit_time += Seconds() - start;
+
+        int col;
+        int starts[LCD_TEXT_HEIGHT];
+        int lengths[LCD_TEXT_HEIGHT];
+        start = Seconds();
+        int row = LineIndexRowOf(&lines, cursor, &col);
+        for (int r = 0; r < LCD_TEXT_HEIGHT; ++r) {
+            starts[r] = LineIndexRowStart(&lines, row + r, &lengths[r]);
+        }
+        map_time += Seconds() - start;
+
+        if (e % SCAN_EVERY) continue;
+        start = Seconds();
+        int scan_col;
+        int scan_row = ScanRowOf(cursor, &scan_col);
+        bool same = scan_row == row && scan_col == col;
+        for (int r = 0; r < LCD_TEXT_HEIGHT; ++r) {
+            int scan_length;
+            same &= ScanRowStart(row + r, &scan_length) == starts[r] &&
+                    scan_length == lengths[r];
+        }
+        scan_time += Seconds() - start;
+        ++scans;
+        if (!same) {
+            fprintf(stderr, "edit %ld: index and scan differ\n", e);
+            return 1;
+        }
+    }
+    printf("%ld edits, %d lines at the end\n", edits,
+           LineIndexLineCount(&lines));
+    Report("index whole document", build, 1);
+    Report("update after an edit", edit_time, edits);
+    Report("map cursor and screen", map_time, edits);
+    Report("scan cursor and screen", scan_time, scans);
+    return 0;
+}
@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lcd_geometry.h"
+#include "packed_text.h"
+#include "piece_table.h"
+
+// Times the 6-bit packed store of the editor against plain bytes,
+// and reports how many characters each fits in the same RAM.
+//
+//   packbench [-n keystrokes] [-s seed]
+//
+// Keystrokes are typed at a cursor that mostly moves by a few
+// characters and jumps once in a while, each followed by reading
+// the 45 characters of a viewport around it. The stores are
+// append-only as the chunks of the piece table are: a keystroke
+// appends its character to the store and the viewport is read from
+// wherever its characters were appended, which the benchmark keeps
+// in an array of store offsets. Appends are timed as a whole, reads
+// one viewport at a time. The same keystrokes are then typed into
+// the piece table itself, which reads through PackedRead.
+
+#define STORE_BYTES 16384
+#define DEFAULT_KEYSTROKES 15000
+#define VIEWPORT (LCD_TEXT_WIDTH * LCD_TEXT_HEIGHT)
+
+static uint8_t packed[STORE_BYTES];
+static char bytes[STORE_BYTES];
+// Store offset of each document position.
+static int offsets[STORE_BYTES];
+static int length;
+static struct PieceTable table;
+
+static double Seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static int Wander(int cursor) {
+    if (rand() % 100 == 0) return rand() % (length + 1);
+    cursor += rand() % 7 - 3;
+    if (cursor < 0) return 0;
+    return cursor > length ? length : cursor;
+}
+
+static void Insert(int cursor) {
+    memmove(offsets + cursor + 1, offsets + cursor,
+            (length - cursor) * sizeof(int));
+    offsets[cursor] = length++;
+}
+
+static int ViewportStart(int cursor) {
+    int from = cursor - VIEWPORT / 2;
+    if (from > length - VIEWPORT) from = length - VIEWPORT;
+    return from < 0 ? 0 : from;
+}
+
+static void Report(const char *name, int capacity, double insert,
+                   double read, long keystrokes) {
+    char chars[32] = "-";
+    if (capacity) snprintf(chars, sizeof(chars), "%d chars", capacity);
+    printf("  %-14s %14s %10.1f ns %10.1f ns\n", name, chars,
+           insert * 1e9 / keystrokes, read * 1e9 / keystrokes);
+}
+
+int main(int argc, char **argv) {
+    long keystrokes = DEFAULT_KEYSTROKES;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 < argc && !strcmp(argv[i], "-n")) {
+            keystrokes = atol(argv[i + 1]);
+        } else if (i + 1 < argc && !strcmp(argv[i], "-s")) {
+            seed = atoi(argv[i + 1]);
+        } else {
+            fprintf(stderr, "usage: %s [-n keystrokes] [-s seed]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (keystrokes < 1 || keystrokes > STORE_BYTES) {
+        fprintf(stderr, "%s: 1 to %d keystrokes\n", argv[0], STORE_BYTES);
+        return 2;
+    }
+
+    char typed[STORE_BYTES];
+    int cursors[STORE_BYTES];
+    srand(seed);
+    int cursor = 0;
+    for (long k = 0; k < keystrokes; ++k) {
+        typed[k] = rand() % 6 ? 'a' + rand() % 26 : ' ';
+        cursors[k] = cursor;
+        Insert(cursor);
+        cursor = Wander(cursor + 1);
+    }
+
+    double times[3][2] = {{0}};
+    double start = Seconds();
+    for (long k = 0; k < keystrokes; ++k) {
+        bytes[k] = typed[k];
+    }
+    times[0][0] = Seconds() - start;
+    start = Seconds();
+    for (long k = 0; k < keystrokes; ++k) {
+        PackedSet(packed, k, typed[k]);
+    }
+    times[1][0] = Seconds() - start;
+
+    char view[2][VIEWPORT];
+    bool same = true;
+    length = 0;
+    for (long k = 0; k < keystrokes; ++k) {
+        Insert(cursors[k]);
+
+        // Reads run by run of consecutive store offsets, as the
+        // piece table reads piece by piece.
+        int from = ViewportStart(cursors[k] + 1);
+        int count = length - from < VIEWPORT ? length - from : VIEWPORT;
+        for (int store = 0; store < 2; ++store) {
+            start = Seconds();
+            for (int i = 0; i < count;) {
+                int run = 1;
+                while (i + run < count &&
+                       offsets[from + i + run] == offsets[from + i] + run) {
+                    ++run;
+                }
+                if (store == 0) {
+                    memcpy(view[0] + i, bytes + offsets[from + i], run);
+                } else {
+                    PackedRead(packed, offsets[from + i], run, view[1] + i);
+                }
+                i += run;
+            }
+            times[store][1] += Seconds() - start;
+        }
+        same &= !memcmp(view[0], view[1], count);
+    }
+    if (!same) {
+        fprintf(stderr, "packed and plain viewports differ\n");
+        return 1;
+    }
+
+    // The editor's own path: the same keystrokes into the piece
+    // table over the chunk pool.
+    length = 0;
+    for (long k = 0; k < keystrokes; ++k) {
+        start = Seconds();
+        bool inserted = PieceTableInsert(&table, cursors[k], typed[k]);
+        times[2][0] += Seconds() - start;
+        if (!inserted) {
+            fprintf(stderr, "keystroke %ld: piece table full\n", k);
+            return 1;
+        }
+        ++length;
+        int from = ViewportStart(cursors[k] + 1);
+        int count = length - from < VIEWPORT ? length - from : VIEWPORT;
+        start = Seconds();
+        for (int i = 0; i < count;) {
+            i += PieceTableRead(&table, from + i, count - i, view[1] + i);
+        }
+        times[2][1] += Seconds() - start;
+    }
+
+    printf("%ld keystrokes, stores of %d bytes\n", keystrokes, STORE_BYTES);
+    printf("  %-14s %14s %13s %13s\n", "", "capacity", "insert",
+           "viewport read");
+    Report("plain bytes", STORE_BYTES, times[0][0], times[0][1],
+           keystrokes);
+    Report("packed", PACKED_CAPACITY(STORE_BYTES), times[1][0],
+           times[1][1], keystrokes);
+    Report("piece table", 0, times[2][0], times[2][1], keystrokes);
+    return 0;
+}
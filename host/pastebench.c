@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "chunk_pool.h"
+#include "piece_table.h"
+
+// Times pasting into the piece table of the editor against
+// inserting the same text by copying bytes into a flat array.
+//
+//   pastebench [-n runs] [-s seed] [-c clipboard]
+//
+// Each run types a clipboard's worth of text, 1 KB by default, copies
+// all of it and pastes it at random positions until the document
+// reaches 32 KB. Memory is the chunks of the pool in use for the
+// piece table and the text length for the byte copy. At the end of
+// each run both documents are compared.
+//
+// Small clipboards take more pastes than the table has pieces for,
+// and a table out of pieces is compacted into fresh chunks: "-c 64"
+// shows that cost.
+
+#define DOCUMENT_SIZE 32768
+#define DEFAULT_RUNS 1000
+#define DEFAULT_CLIPBOARD 1024
+
+static struct PieceTable document;
+static struct PieceTable clipboard;
+static char text[DOCUMENT_SIZE];
+static char clip[DOCUMENT_SIZE / 2];
+static char read_back[DOCUMENT_SIZE];
+static int length;
+
+static double Seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static int UsedChunks(void) {
+    struct ChunkPoolUsage usage;
+    ChunkPoolReport(&usage);
+    return usage.used_chunks;
+}
+
+int main(int argc, char **argv) {
+    long runs = DEFAULT_RUNS;
+    unsigned seed = 1;
+    int size = DEFAULT_CLIPBOARD;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 < argc && !strcmp(argv[i], "-n")) {
+            runs = atol(argv[i + 1]);
+        } else if (i + 1 < argc && !strcmp(argv[i], "-s")) {
+            seed = atoi(argv[i + 1]);
+        } else if (i + 1 < argc && !strcmp(argv[i], "-c")) {
+            size = atoi(argv[i + 1]);
+        } else {
+            fprintf(stderr, "usage: %s [-n runs] [-s seed] [-c clipboard]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    if (size < 1 || size > DOCUMENT_SIZE / 2) {
+        fprintf(stderr, "%s: clipboard of 1 to %d characters\n", argv[0],
+                DOCUMENT_SIZE / 2);
+        return 2;
+    }
+    srand(seed);
+
+    double table_time = 0;
+    double bytes_time = 0;
+    long pastes = 0;
+    int typed_chunks = 0;
+    int pasted_chunks = 0;
+    for (long run = 0; run < runs; ++run) {
+        PieceTableClear(&document);
+        PieceTableClear(&clipboard);
+        length = 0;
+        for (int i = 0; i < size; ++i) {
+            char c = rand() % 6 ? 'a' + rand() % 26 : ' ';
+            PieceTableInsert(&document, i, c);
+            text[length++] = c;
+            clip[i] = c;
+        }
+        PieceTableCopy(&document, 0, size, &clipboard);
+        typed_chunks = UsedChunks();
+
+        while (length + size <= DOCUMENT_SIZE) {
+            int position = rand() % (length + 1);
+            double start = Seconds();
+            bool pasted = PieceTablePaste(&document, position, &clipboard);
+            table_time += Seconds() - start;
+            if (!pasted) {
+                fprintf(stderr, "run %ld: out of pieces\n", run);
+                return 1;
+            }
+            start = Seconds();
+            memmove(text + position + size, text + position,
+                    length - position);
+            memcpy(text + position, clip, size);
+            bytes_time += Seconds() - start;
+            length += size;
+            ++pastes;
+        }
+        pasted_chunks = UsedChunks();
+
+        int count = 0;
+        while (count < length) {
+            count += PieceTableRead(&document, count, length - count,
+                                    read_back + count);
+        }
+        if (document.length != length || memcmp(read_back, text, length)) {
+            fprintf(stderr, "run %ld: piece table and bytes differ\n", run);
+            return 1;
+        }
+    }
+
+    printf("%ld runs of %ld pastes of %d characters, up to %d\n", runs,
+           pastes / runs, size, length);
+    printf("  %-12s %10s %22s\n", "", "per paste", "memory after pastes");
+    printf("  %-12s %7.1f ns %12d chunks, +%d\n", "piece table",
+           table_time * 1e9 / pastes, pasted_chunks,
+           pasted_chunks - typed_chunks);
+    printf("  %-12s %7.1f ns %12d bytes, +%d\n", "byte copy",
+           bytes_time * 1e9 / pastes, length, length - size);
+    return 0;
+}
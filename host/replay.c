@@ -0,0 +1,324 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "editor.h"
+#include "hardware.h"
+#include "keyboard.h"
+#include "spell_check.h"
+#include "synced_lcd.h"
+
+// Replays keypad traces through keyboard.c, the editor and lcd.c
+// running on stand-in hardware, and reports what each editor event
+// cost.
+//
+// A trace has an event per line: the time in milliseconds, "press"
+// or "release", and the row and column of the key. Lines starting
+// with '#' are comments. A key pressed while another one is held
+// makes an ambiguous press, as on the board.
+//
+// An event is a timer tick that called back the editor: a press,
+// a fix, an ambiguous press or a repeat of a held key. Its cost is
+// that of the callbacks and of the main loop iteration that follows:
+// SyncedLCDsync, the idle spell check and another sync for its
+// underlines. The firmware leaves the spell check out until it has
+// a full dictionary, so this is an upper bound for it.
+// Cycles are host cycles and include the stand-in hardware, so
+// they only compare builds on one machine, and are only printed.
+//
+// "make results" replays the canonical traces into results.txt,
+// one line per trace and metric other than cycles, to be diffed
+// between builds.
+
+#define MAX_TRACE_EVENTS 65536
+// Run after the last key event, for pending fixes.
+#define SETTLE_MS 2000
+
+struct KeyEvent {
+    int time;
+    bool pressed;
+    int row;
+    int col;
+};
+
+enum Metric {
+    METRIC_SPI_BITS,
+    METRIC_GLYPH_BLITS,
+    METRIC_WINDOWS,
+    METRIC_PIXELS,
+    // The cycles, last, vary from run to run.
+    METRIC_EDITOR_CYCLES,
+    METRIC_RENDER_CYCLES,
+    METRIC_IDLE_CYCLES,
+    METRIC_COUNT,
+};
+
+static const char *metric_names[METRIC_COUNT] = {
+    "spi_bits", "glyph_blits", "window_commands", "pixels",
+    "editor_cycles", "render_cycles", "idle_cycles",
+};
+
+enum Callback {
+    CALLBACK_PRESSED,
+    CALLBACK_FIX,
+    CALLBACK_AMBIGUOUS,
+    CALLBACK_HELD,
+    CALLBACK_COUNT,
+};
+
+static const char *callback_names[CALLBACK_COUNT] = {
+    "presses", "fixes", "ambiguous_presses", "repeats",
+};
+
+static struct KeyEvent trace[MAX_TRACE_EVENTS];
+static int trace_length;
+
+// Per event samples of each metric, and their totals, which also
+// count ticks that did not call the editor.
+static uint64_t *samples[METRIC_COUNT];
+static int sample_count;
+static uint64_t totals[METRIC_COUNT];
+static int callback_counts[CALLBACK_COUNT];
+
+// Editor time of the current tick.
+static uint64_t tick_editor_cycles;
+static int tick_callbacks;
+
+static uint64_t Cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+// The editor callbacks of keyboard.c are wrapped by the linker,
+// see the makefile.
+void __real_ButtonPressed(int row, int col);
+void __real_FixButton(void);
+void __real_AmbiguousPress(void);
+void __real_ButtonHeld(int row, int col, int repeat);
+
+static void CallbackDone(enum Callback callback, uint64_t start) {
+    tick_editor_cycles += Cycles() - start;
+    ++tick_callbacks;
+    ++callback_counts[callback];
+}
+
+void __wrap_ButtonPressed(int row, int col) {
+    uint64_t start = Cycles();
+    __real_ButtonPressed(row, col);
+    CallbackDone(CALLBACK_PRESSED, start);
+}
+
+void __wrap_FixButton(void) {
+    uint64_t start = Cycles();
+    __real_FixButton();
+    CallbackDone(CALLBACK_FIX, start);
+}
+
+void __wrap_AmbiguousPress(void) {
+    uint64_t start = Cycles();
+    __real_AmbiguousPress();
+    CallbackDone(CALLBACK_AMBIGUOUS, start);
+}
+
+void __wrap_ButtonHeld(int row, int col, int repeat) {
+    uint64_t start = Cycles();
+    __real_ButtonHeld(row, col, repeat);
+    CallbackDone(CALLBACK_HELD, start);
+}
+
+static bool LoadTrace(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    char line[128];
+    int line_number = 0;
+    trace_length = 0;
+    while (fgets(line, sizeof(line), file)) {
+        ++line_number;
+        if (line[0] == '#' || line[0] == '\n') continue;
+        struct KeyEvent event;
+        char kind[16];
+        if (sscanf(line, "%d %15s %d %d", &event.time, kind, &event.row,
+                   &event.col) != 4 ||
+            (strcmp(kind, "press") && strcmp(kind, "release")) ||
+            event.row < 0 || event.row > 3 ||
+            event.col < 0 || event.col > 3 ||
+            (trace_length && event.time < trace[trace_length - 1].time) ||
+            trace_length == MAX_TRACE_EVENTS) {
+            fprintf(stderr, "%s:%d: bad event\n", path, line_number);
+            fclose(file);
+            return false;
+        }
+        event.pressed = !strcmp(kind, "press");
+        trace[trace_length++] = event;
+    }
+    fclose(file);
+    return true;
+}
+
+static void Record(const uint64_t *values) {
+    for (int m = 0; m < METRIC_COUNT; ++m) {
+        samples[m] = realloc(samples[m],
+                             (sample_count + 1) * sizeof(uint64_t));
+        samples[m][sample_count] = values[m];
+    }
+    ++sample_count;
+}
+
+static void Tick(void) {
+    // The timer interrupt, then the main loop catching up.
+    tick_editor_cycles = 0;
+    tick_callbacks = 0;
+    TIM3_IRQHandler();
+
+    struct LcdCounters before = lcd_counters;
+    uint64_t values[METRIC_COUNT];
+    uint64_t start = Cycles();
+    SyncedLCDsync();
+    HostGpioFlush();
+    values[METRIC_RENDER_CYCLES] = Cycles() - start;
+    start = Cycles();
+    SpellCheckIdle();
+    values[METRIC_IDLE_CYCLES] = Cycles() - start;
+    start = Cycles();
+    SyncedLCDsync();
+    HostGpioFlush();
+    values[METRIC_RENDER_CYCLES] += Cycles() - start;
+    values[METRIC_EDITOR_CYCLES] = tick_editor_cycles;
+    values[METRIC_SPI_BITS] = lcd_counters.spi_bits - before.spi_bits;
+    values[METRIC_GLYPH_BLITS] = lcd_counters.glyphs - before.glyphs;
+    values[METRIC_WINDOWS] = lcd_counters.windows - before.windows;
+    values[METRIC_PIXELS] = lcd_counters.pixels - before.pixels;
+    for (int m = 0; m < METRIC_COUNT; ++m) {
+        totals[m] += values[m];
+    }
+    if (tick_callbacks) {
+        Record(values);
+    }
+}
+
+static void Run(void) {
+    HostHardwareConfigure();
+    SyncedLCDconfigure();
+    EditorConfigure();
+    KeyboardConfigure();
+    SyncedLCDsync();
+    HostGpioFlush();
+    // Only the trace is measured.
+    memset(&lcd_counters, 0, sizeof(lcd_counters));
+
+    int next = 0;
+    int end = trace_length ? trace[trace_length - 1].time + SETTLE_MS : 0;
+    for (int time = 0; time <= end; ++time) {
+        for (; next < trace_length && trace[next].time == time; ++next) {
+            HostKeySet(trace[next].row, trace[next].col, trace[next].pressed);
+            if (trace[next].pressed && HostRowInterruptPending()) {
+                EXTI9_5_IRQHandler();
+            }
+        }
+        if (HostTimerStep()) {
+            Tick();
+        }
+    }
+}
+
+static int CompareSamples(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *) a;
+    uint64_t y = *(const uint64_t *) b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t Percentile(uint64_t *sorted, int percent) {
+    // Nearest rank.
+    if (!sample_count) return 0;
+    return sorted[(sample_count - 1) * percent / 100];
+}
+
+static void Report(const char *name, FILE *results) {
+    printf("%s: %d events,", name, sample_count);
+    for (int c = 0; c < CALLBACK_COUNT; ++c) {
+        printf(" %d %s", callback_counts[c], callback_names[c]);
+    }
+    printf("\n  %-16s %14s %10s %10s\n", "", "total", "p50", "p99");
+    fprintf(results, "%s events %d - -\n", name, sample_count);
+    for (int m = 0; m < METRIC_COUNT; ++m) {
+        qsort(samples[m], sample_count, sizeof(uint64_t), CompareSamples);
+        unsigned long long p50 = Percentile(samples[m], 50);
+        unsigned long long p99 = Percentile(samples[m], 99);
+        printf("  %-16s %14llu %10llu %10llu\n", metric_names[m],
+               (unsigned long long) totals[m], p50, p99);
+        if (m < METRIC_EDITOR_CYCLES) {
+            fprintf(results, "%s %s %llu %llu %llu\n", name,
+                    metric_names[m], (unsigned long long) totals[m], p50,
+                    p99);
+        }
+    }
+    printf("  lcd_hash %016llx\n", (unsigned long long) lcd_counters.hash);
+    fprintf(results, "%s lcd_hash %016llx - -\n", name,
+            (unsigned long long) lcd_counters.hash);
+}
+
+static void TraceName(const char *path, char *name, size_t size) {
+    const char *slash = strrchr(path, '/');
+    snprintf(name, size, "%s", slash ? slash + 1 : path);
+    char *dot = strrchr(name, '.');
+    if (dot) *dot = '\0';
+}
+
+int main(int argc, char **argv) {
+    const char *results_path = "results.txt";
+    int first = 1;
+    if (argc > 2 && !strcmp(argv[1], "-o")) {
+        results_path = argv[2];
+        first = 3;
+    }
+    if (first >= argc) {
+        fprintf(stderr, "usage: %s [-o results] trace...\n", argv[0]);
+        return 2;
+    }
+    FILE *results = fopen(results_path, "w");
+    if (!results) {
+        perror(results_path);
+        return 1;
+    }
+    fprintf(results, "# trace metric total p50 p99\n");
+
+    // Each trace runs in a process of its own, so that it starts
+    // from a fresh editor.
+    int failed = 0;
+    for (int i = first; i < argc; ++i) {
+        fflush(stdout);
+        fflush(results);
+        pid_t pid = fork();
+        if (pid == 0) {
+            if (!LoadTrace(argv[i])) _exit(1);
+            char name[64];
+            TraceName(argv[i], name, sizeof(name));
+            Run();
+            Report(name, results);
+            fclose(results);
+            fflush(stdout);
+            _exit(0);
+        }
+        int status;
+        if (pid < 0 || waitpid(pid, &status, 0) < 0 ||
+            !WIFEXITED(status) || WEXITSTATUS(status)) {
+            fprintf(stderr, "%s: replay failed\n", argv[i]);
+            failed = 1;
+        }
+    }
+    fclose(results);
+    return failed;
+}
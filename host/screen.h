@@ -0,0 +1,28 @@
+#ifndef _SCREEN_H
+#define _SCREEN_H 1
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lcd_geometry.h"
+
+// The text cells as the LCD shows them, read back for fuzz.c from
+// what stands in for the LCD: screen_cells.c, which implements lcd.h
+// cell by cell, or screen_spi.c, which decodes the pixels lcd.c sent
+// to hardware.c.
+struct ScreenCell {
+    char c;
+    uint16_t text;
+    uint16_t back;
+    bool underline;
+    // Drawn inconsistently: its pixels are no glyph, or lcd.h was
+    // called with a cell it does not show.
+    bool garbled;
+};
+
+typedef struct ScreenCell Screen[LCD_TEXT_HEIGHT][LCD_TEXT_WIDTH];
+
+// Before SyncedLCDconfigure.
+void ScreenConfigure(void);
+void ScreenRead(Screen screen);
+
+#endif
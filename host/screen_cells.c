@@ -0,0 +1,104 @@
+#include "lcd.h"
+#include "screen.h"
+
+// lcd.h drawing into text cells instead of pixels, fast enough to
+// fuzz the editor and synced_lcd.c with thousands of sequences per
+// second. The glyph kernels of lcd.c are fuzzed by screen_spi.c.
+
+static Screen screen;
+static int line, position;
+
+static bool OnScreen(void) {
+    return line >= 0 && line < LCD_TEXT_HEIGHT &&
+           position >= 0 && position < LCD_TEXT_WIDTH;
+}
+
+static void Draw(char c, uint16_t text, uint16_t back, bool underline) {
+    if (!OnScreen()) return;
+    struct ScreenCell *cell = &screen[line][position];
+    cell->c = c;
+    cell->text = text;
+    cell->back = back;
+    cell->underline = underline;
+    cell->garbled = false;
+}
+
+void ScreenConfigure(void) {
+}
+
+void ScreenRead(Screen out) {
+    for (int i = 0; i < LCD_TEXT_HEIGHT; ++i) {
+        for (int j = 0; j < LCD_TEXT_WIDTH; ++j) {
+            out[i][j] = screen[i][j];
+        }
+    }
+}
+
+void LCDconfigure(void) {
+    LCDclear();
+}
+
+void LCDclear(void) {
+    for (line = 0; line < LCD_TEXT_HEIGHT; ++line) {
+        for (position = 0; position < LCD_TEXT_WIDTH; ++position) {
+            Draw(' ', LCD_COLOR_WHITE, LCD_COLOR_BLUE, false);
+        }
+    }
+    LCDgoto(0, 0);
+}
+
+void LCDgoto(int textLine, int charPos) {
+    line = textLine;
+    position = charPos;
+}
+
+void LCDputchar(char c) {
+    if (c == '\n') {
+        LCDgoto(line + 1, 0);
+    } else if (c == '\r') {
+        LCDgoto(line, 0);
+    } else if (c == '\t') {
+        LCDgoto(line, (position + 8) & ~7);
+    } else {
+        Draw(c, LCD_COLOR_WHITE, LCD_COLOR_BLUE, false);
+        ++position;
+    }
+}
+
+void LCDputcharWrap(char c) {
+    if (position >= LCD_TEXT_WIDTH &&
+        c != '\t' && c != '\r' && c != '\n' && c != ' ') {
+        LCDputchar('\n');
+    }
+    LCDputchar(c);
+}
+
+void LCDbackspace(void) {
+    if (position >= 1) {
+        LCDgoto(line, position - 1);
+    } else if (line > 0) {
+        LCDgoto(line - 1, LCD_TEXT_WIDTH - 1);
+    }
+    Draw(' ', LCD_COLOR_WHITE, LCD_COLOR_BLUE, false);
+}
+
+void LCDputchars(const char *s, int count, uint16_t text, uint16_t back,
+                 int underline) {
+    for (int k = 0; k < count && position < LCD_TEXT_WIDTH; ++k) {
+        // Characters without a glyph are drawn as spaces.
+        char c = s[k] >= ' ' && s[k] <= '~' ? s[k] : ' ';
+        Draw(c, text, back, underline);
+        ++position;
+    }
+}
+
+void LCDunderline(char c, int on, uint16_t text, uint16_t back) {
+    // Only the bottom pixel row is drawn, the rest of the cell must
+    // already be that character in these colours.
+    if (!OnScreen() || c < ' ' || c > '~') return;
+    struct ScreenCell *cell = &screen[line][position];
+    if (cell->text != text || cell->back != back || cell->c != c) {
+        cell->garbled = true;
+    }
+    cell->underline = on;
+}
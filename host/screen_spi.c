@@ -0,0 +1,86 @@
+#include <fonts.h>
+#include "hardware.h"
+#include "lcd.h"
+#include "screen.h"
+
+// Text cells decoded from the pixels lcd.c sent over the stand-in
+// serial line. A cell is decoded by finding its two colours and the
+// glyph whose bits select the foreground; the bottom row may be a
+// line instead.
+
+#define GLYPH_COUNT (LAST_CHAR - FIRST_CHAR + 1)
+#define FULL_ROW ((1U << LCD_FONT_WIDTH) - 1)
+
+static bool Decode(int row, int col, uint16_t text, uint16_t back,
+                   struct ScreenCell *cell) {
+    // Tries text as the foreground.
+    int x0 = LCD_X_OFFSET + col * LCD_FONT_WIDTH;
+    int y0 = LCD_Y_OFFSET + row * LCD_FONT_HEIGHT;
+    uint32_t bits[LCD_FONT_HEIGHT];
+    for (int i = 0; i < LCD_FONT_HEIGHT; ++i) {
+        bits[i] = 0;
+        for (int j = 0; j < LCD_FONT_WIDTH; ++j) {
+            uint16_t pixel = lcd_frame[y0 + i][x0 + j];
+            if (pixel == text) {
+                bits[i] |= 1U << j;
+            } else if (pixel != back) {
+                return false;
+            }
+        }
+    }
+    for (int g = 0; g < GLYPH_COUNT; ++g) {
+        const uint16_t *glyph = &host_font.table[g * LCD_FONT_HEIGHT];
+        int i = 0;
+        while (i < LCD_FONT_HEIGHT - 1 && (glyph[i] & FULL_ROW) == bits[i]) {
+            ++i;
+        }
+        if (i < LCD_FONT_HEIGHT - 1) continue;
+        uint32_t last = glyph[LCD_FONT_HEIGHT - 1] & FULL_ROW;
+        if (bits[i] != last && bits[i] != FULL_ROW) continue;
+        cell->c = FIRST_CHAR + g;
+        cell->text = text;
+        cell->back = back;
+        cell->underline = bits[i] != last;
+        cell->garbled = false;
+        return true;
+    }
+    return false;
+}
+
+void ScreenConfigure(void) {
+    HostHardwareConfigure();
+}
+
+void ScreenRead(Screen screen) {
+    for (int row = 0; row < LCD_TEXT_HEIGHT; ++row) {
+        for (int col = 0; col < LCD_TEXT_WIDTH; ++col) {
+            // The glyphs of hardware.c are random enough to always
+            // have both colours, a cell of one colour has not been
+            // drawn since LCDconfigure cleared it to white on blue.
+            int x = LCD_X_OFFSET + col * LCD_FONT_WIDTH;
+            int y = LCD_Y_OFFSET + row * LCD_FONT_HEIGHT;
+            uint16_t a = lcd_frame[y][x];
+            uint16_t b = a;
+            for (int i = 0; i < LCD_FONT_HEIGHT && b == a; ++i) {
+                for (int j = 0; j < LCD_FONT_WIDTH && b == a; ++j) {
+                    b = lcd_frame[y + i][x + j];
+                }
+            }
+            struct ScreenCell *cell = &screen[row][col];
+            if (a == b) {
+                cell->c = ' ';
+                cell->text = LCD_COLOR_WHITE;
+                cell->back = a;
+                cell->underline = false;
+                cell->garbled = a != LCD_COLOR_BLUE;
+            } else if (!Decode(row, col, a, b, cell) &&
+                       !Decode(row, col, b, a, cell)) {
+                cell->c = '?';
+                cell->text = a;
+                cell->back = b;
+                cell->underline = false;
+                cell->garbled = true;
+            }
+        }
+    }
+}
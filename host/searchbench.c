@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "piece_table.h"
+#include "text_search.h"
+
+// Times the incremental search of the editor against rescanning the
+// text from its start for the whole query after every key.
+//
+//   searchbench [-n runs] [-s seed] [-q query]
+//
+// Each run types a 32 KB document of random words, with the query
+// placed near its end, into a piece table of 128-character pieces
+// and then types the query one key at a time, as search mode does.
+// The incremental search resumes from the match of the prefix with
+// SearchPush. The rescan compares character by character with
+// PieceTableCharAt. Both must find the same positions.
+
+#define DOCUMENT_SIZE 32768
+#define BLOCK_SIZE 128
+#define DEFAULT_RUNS 200
+#define DEFAULT_QUERY "syzygies"
+
+static struct PieceTable document;
+static struct Search search;
+
+static double Seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+static void Generate(const char *query) {
+    static char text[DOCUMENT_SIZE];
+    int length = 0;
+    int target = DOCUMENT_SIZE - DOCUMENT_SIZE / 16;
+    int m = strlen(query);
+    while (length < DOCUMENT_SIZE) {
+        if (length >= target && length + m + 1 <= DOCUMENT_SIZE) {
+            memcpy(text + length, query, m);
+            length += m;
+            target = DOCUMENT_SIZE;
+        } else {
+            int word = 1 + rand() % 8;
+            for (int i = 0; i < word && length < DOCUMENT_SIZE - 1; ++i) {
+                text[length++] = 'a' + rand() % 26;
+            }
+        }
+        text[length++] = ' ';
+    }
+
+    // Typed block by block from the last one, each at the start, so
+    // that every block is a piece of its own.
+    PieceTableClear(&document);
+    for (int block = DOCUMENT_SIZE / BLOCK_SIZE - 1; block >= 0; --block) {
+        for (int i = 0; i < BLOCK_SIZE; ++i) {
+            PieceTableInsert(&document, i, text[block * BLOCK_SIZE + i]);
+        }
+    }
+}
+
+static int Rescan(const char *query, int m) {
+    for (int p = 0; p + m <= document.length; ++p) {
+        int i = 0;
+        while (i < m && PieceTableCharAt(&document, p + i) == query[i]) ++i;
+        if (i == m) return p;
+    }
+    return -1;
+}
+
+int main(int argc, char **argv) {
+    long runs = DEFAULT_RUNS;
+    unsigned seed = 1;
+    const char *query = DEFAULT_QUERY;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 < argc && !strcmp(argv[i], "-n")) {
+            runs = atol(argv[i + 1]);
+        } else if (i + 1 < argc && !strcmp(argv[i], "-s")) {
+            seed = atoi(argv[i + 1]);
+        } else if (i + 1 < argc && !strcmp(argv[i], "-q")) {
+            query = argv[i + 1];
+        } else {
+            fprintf(stderr, "usage: %s [-n runs] [-s seed] [-q query]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+    int m = strlen(query);
+    if (m < 1 || m > SEARCH_MAX_QUERY || strspn(query, "abcdefghijklmnopqrstu"
+                                                "vwxyz") != (size_t) m) {
+        fprintf(stderr, "%s: a query of 1 to %d lowercase letters\n",
+                argv[0], SEARCH_MAX_QUERY);
+        return 2;
+    }
+    srand(seed);
+
+    double incremental[SEARCH_MAX_QUERY] = {0};
+    double rescan[SEARCH_MAX_QUERY] = {0};
+    for (long run = 0; run < runs; ++run) {
+        Generate(query);
+        SearchStart(&search, 0);
+        for (int k = 0; k < m; ++k) {
+            double start = Seconds();
+            SearchPush(&search, &document, query[k]);
+            int length;
+            int found = SearchFound(&search, &length);
+            incremental[k] += Seconds() - start;
+            start = Seconds();
+            int scanned = Rescan(query, k + 1);
+            rescan[k] += Seconds() - start;
+            if (length != k + 1 || found != scanned) {
+                fprintf(stderr, "run %ld, key %d: found %d, rescan %d\n",
+                        run, k + 1, length == k + 1 ? found : -1, scanned);
+                return 1;
+            }
+        }
+    }
+
+    printf("%ld runs, %d characters in %d pieces, query \"%s\"\n", runs,
+           document.length, document.piece_count, query);
+    printf("  %-6s %12s %12s\n", "key", "incremental", "rescan");
+    double total[2] = {0, 0};
+    for (int k = 0; k < m; ++k) {
+        printf("  %-6d %9.1f us %9.1f us\n", k + 1,
+               incremental[k] * 1e6 / runs, rescan[k] * 1e6 / runs);
+        total[0] += incremental[k];
+        total[1] += rescan[k];
+    }
+    printf("  %-6s %9.1f us %9.1f us\n", "mean", total[0] * 1e6 / runs / m,
+           total[1] * 1e6 / runs / m);
+    return 0;
+}
@@ -0,0 +1,274 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "chunk_pool.h"
+#include "piece_table.h"
+
+// Soaks the piece tables and the chunk pool with random edits across
+// document slots and a clipboard, checked against plain arrays.
+//
+//   soak [-n edits] [-s seed]
+//
+// Built with a pool of POOL_CHUNKS chunks, 16 by the makefile, so
+// that it runs out of chunks and pieces all the time: a failed edit
+// is retried after PieceTableCollect, as the editor does, and must
+// leave the text unchanged if it fails again. Every edit checks the
+// text it changed, and every CHECK_EVERY edits all texts are checked,
+// as are the reference counts of the chunks and, after a collection
+// that left a chunk free, that at most one chunk other than those
+// being appended to is half empty or worse. The pool usage is
+// reported at the end; like the editor, the soak only collects when
+// an edit fails, and the chunks the five tables append to are never
+// collected, so a small pool can stay mostly wasted.
+
+#define SLOTS 4
+#define DEFAULT_EDITS 1000000
+#define CHECK_EVERY 16
+// Pastes refer to text instead of copying it, so texts may outgrow
+// the pool, up to this.
+#define MAX_TEXT 8192
+#define MAX_RUN 8
+#define MAX_DELETE 16
+#define MAX_COPY 512
+
+struct Text {
+    char chars[MAX_TEXT];
+    int length;
+};
+
+// The slots and the clipboard, last.
+static struct PieceTable tables[SLOTS + 1];
+static struct PieceTable *const table_pointers[SLOTS + 1] = {
+    &tables[0], &tables[1], &tables[2], &tables[3], &tables[4],
+};
+static struct Text texts[SLOTS + 1];
+static char read_back[MAX_TEXT];
+
+static long collections;
+static long failures;
+static double worst_waste;
+
+static char RandomChar(void) {
+    return rand() % 6 ? 'a' + rand() % 26 : ' ';
+}
+
+static void Collect(void) {
+    // After a failed edit, as StoreCollect in editor.c.
+    PieceTableCollect(table_pointers, SLOTS + 1);
+    ++collections;
+
+    struct ChunkPoolUsage usage;
+    ChunkPoolReport(&usage);
+    if (usage.used_chunks) {
+        double waste = 1 - (double) usage.referenced_symbols /
+                           (usage.used_chunks * CHUNK_SYMBOLS);
+        if (waste > worst_waste) worst_waste = waste;
+    }
+    if (ChunkFreeCount() < 1) return;
+    int sparse = 0;
+    for (int c = 0; c < POOL_CHUNKS; ++c) {
+        bool appending = false;
+        for (int t = 0; t <= SLOTS; ++t) {
+            appending |= tables[t].append_fill && tables[t].append_chunk == c;
+        }
+        if (!appending && ChunkReferences(c) &&
+            ChunkReferences(c) <= CHUNK_SYMBOLS / 2) {
+            ++sparse;
+        }
+    }
+    if (sparse > 1) {
+        fprintf(stderr, "collection %ld: %d sparse chunks left\n",
+                collections, sparse);
+        exit(1);
+    }
+}
+
+static bool SameText(int t) {
+    struct PieceTable *table = &tables[t];
+    if (table->length != texts[t].length) return false;
+    for (int position = 0; position < table->length;) {
+        int count = PieceTableRead(table, position, table->length - position,
+                                   read_back + position);
+        if (count <= 0) return false;
+        position += count;
+    }
+    // And a character at a time, backwards as word motions go, which
+    // shows a decoded window left over from before an edit.
+    for (int position = table->length; position >= 0; --position) {
+        char c = position < table->length ? texts[t].chars[position] : '\0';
+        if (PieceTableCharAt(table, position) != c) return false;
+    }
+    return !memcmp(read_back, texts[t].chars, table->length);
+}
+
+static bool SameReferences(void) {
+    // Every piece refers to its symbols, and a table to the chunk it
+    // appends to.
+    static int references[POOL_CHUNKS];
+    memset(references, 0, sizeof(references));
+    for (int t = 0; t <= SLOTS; ++t) {
+        for (int k = 0; k < tables[t].piece_count; ++k) {
+            references[tables[t].pieces[k].start / CHUNK_SYMBOLS] +=
+                tables[t].pieces[k].length;
+        }
+        if (tables[t].append_fill) ++references[tables[t].append_chunk];
+    }
+    int used = 0;
+    for (int c = 0; c < POOL_CHUNKS; ++c) {
+        if (references[c] != ChunkReferences(c)) return false;
+        used += references[c] > 0;
+    }
+    struct ChunkPoolUsage usage;
+    ChunkPoolReport(&usage);
+    return usage.used_chunks == used && ChunkFreeCount() == POOL_CHUNKS - used;
+}
+
+static void Insert(struct Text *text, int position, const char *chars,
+                   int count) {
+    memmove(text->chars + position + count, text->chars + position,
+            text->length - position);
+    memcpy(text->chars + position, chars, count);
+    text->length += count;
+}
+
+static void Delete(struct Text *text, int position, int count) {
+    memmove(text->chars + position, text->chars + position + count,
+            text->length - position - count);
+    text->length -= count;
+}
+
+// Each edit is retried once after a collection.
+
+static bool EditInsert(int t, int position, char c) {
+    bool done = PieceTableInsert(&tables[t], position, c);
+    if (!done) {
+        Collect();
+        done = PieceTableInsert(&tables[t], position, c);
+    }
+    if (done) Insert(&texts[t], position, &c, 1);
+    return done;
+}
+
+static bool EditReplace(int t, int position, char c) {
+    bool done = PieceTableReplace(&tables[t], position, c);
+    if (!done) {
+        Collect();
+        done = PieceTableReplace(&tables[t], position, c);
+    }
+    if (done) texts[t].chars[position] = c;
+    return done;
+}
+
+static bool EditDelete(int t, int position, int count) {
+    bool done = PieceTableDelete(&tables[t], position, count);
+    if (!done) {
+        Collect();
+        done = PieceTableDelete(&tables[t], position, count);
+    }
+    if (done) Delete(&texts[t], position, count);
+    return done;
+}
+
+static bool EditPaste(int t, int position) {
+    struct PieceTable *clipboard = &tables[SLOTS];
+    bool done = PieceTablePaste(&tables[t], position, clipboard);
+    if (!done) {
+        Collect();
+        done = PieceTablePaste(&tables[t], position, clipboard);
+    }
+    if (done) {
+        Insert(&texts[t], position, texts[SLOTS].chars, texts[SLOTS].length);
+    }
+    return done;
+}
+
+static bool Edit(int t) {
+    // Typing and deleting balance out, so the texts wander around
+    // the size of the pool.
+    struct Text *text = &texts[t];
+    int position = rand() % (text->length + 1);
+    int op = rand() % 100;
+    if (op < 55) {
+        int run = 1 + rand() % MAX_RUN;
+        for (int i = 0; i < run && text->length < MAX_TEXT; ++i) {
+            if (!EditInsert(t, position + i, RandomChar())) {
+                ++failures;
+                break;
+            }
+        }
+    } else if (op < 85) {
+        int count = 1 + rand() % MAX_DELETE;
+        if (count > text->length - position) count = text->length - position;
+        if (count > 0 && !EditDelete(t, position, count)) ++failures;
+    } else if (op < 93) {
+        if (position < text->length &&
+            !EditReplace(t, position, RandomChar())) {
+            ++failures;
+        }
+    } else if (op < 96) {
+        int count = rand() % (MAX_COPY + 1);
+        if (count > text->length - position) count = text->length - position;
+        PieceTableCopy(&tables[t], position, count, &tables[SLOTS]);
+        memcpy(texts[SLOTS].chars, text->chars + position, count);
+        texts[SLOTS].length = count;
+        return SameText(SLOTS);
+    } else if (op < 99) {
+        if (text->length + texts[SLOTS].length <= MAX_TEXT &&
+            !EditPaste(t, position)) {
+            ++failures;
+        }
+    } else {
+        PieceTableClear(&tables[t]);
+        text->length = 0;
+    }
+    return SameText(t);
+}
+
+int main(int argc, char **argv) {
+    long edits = DEFAULT_EDITS;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 < argc && !strcmp(argv[i], "-n")) {
+            edits = atol(argv[i + 1]);
+        } else if (i + 1 < argc && !strcmp(argv[i], "-s")) {
+            seed = atoi(argv[i + 1]);
+        } else {
+            fprintf(stderr, "usage: %s [-n edits] [-s seed]\n", argv[0]);
+            return 2;
+        }
+    }
+    srand(seed);
+
+    for (long e = 0; e < edits; ++e) {
+        if (!Edit(rand() % SLOTS)) {
+            fprintf(stderr, "edit %ld: text differs\n", e);
+            return 1;
+        }
+        if (e % CHECK_EVERY) continue;
+        for (int t = 0; t <= SLOTS; ++t) {
+            if (!SameText(t)) {
+                fprintf(stderr, "edit %ld: text %d differs\n", e, t);
+                return 1;
+            }
+        }
+        if (!SameReferences()) {
+            fprintf(stderr, "edit %ld: chunk references differ\n", e);
+            return 1;
+        }
+    }
+
+    struct ChunkPoolUsage usage;
+    ChunkPoolReport(&usage);
+    printf("%ld edits across %d slots, a pool of %d chunks of %d\n", edits,
+           SLOTS, POOL_CHUNKS, CHUNK_SYMBOLS);
+    printf("  %ld collections, %ld edits failed after one\n", collections,
+           failures);
+    printf("  used chunks %d, peak %d\n", usage.used_chunks,
+           usage.peak_used_chunks);
+    printf("  referenced symbols %d, %.1f%% of the used chunks wasted\n",
+           usage.referenced_symbols, usage.used_chunks
+           ? 100 - 100.0 * usage.referenced_symbols /
+                   (usage.used_chunks * CHUNK_SYMBOLS) : 0.0);
+    printf("  most wasted after a collection %.1f%%\n", 100 * worst_waste);
+    return 0;
+}
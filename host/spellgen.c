@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "bloom_filter.h"
+#include "lcd_geometry.h"
+
+// Builds the spell check dictionary: reads a word list, one word
+// per line, and writes the Bloom filter as C to the standard output.
+// The false positive rate, measured on random strings that are not
+// in the list, goes to the standard error.
+//
+//   spellgen [-s bytes] [-k hashes] [-t checks] words.txt
+//
+// By default the filter takes a byte per word, for about 2%
+// false positives with 5 hashes.
+//
+// With -t, nothing is written and the worst case of a check is
+// timed instead: the longest word the spell check looks up, one
+// that fills the screen but for a cell at each end, added to the
+// filter so that every probe passes, is looked up that many times.
+
+#define DEFAULT_HASHES 5
+#define MAX_WORDS 200000
+#define MAX_WORD 32
+#define PROBES 1000000
+#define PROBE_LENGTH 7
+#define LONGEST_CHECKED (LCD_TEXT_WIDTH * LCD_TEXT_HEIGHT - 2)
+
+static char words[MAX_WORDS][MAX_WORD];
+static int word_count;
+
+static int CompareWords(const void *a, const void *b) {
+    return strcmp(a, b);
+}
+
+static bool LoadWords(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        int length = strcspn(line, "\r\n");
+        if (length == 0 || length >= MAX_WORD) continue;
+        if (word_count == MAX_WORDS) {
+            fprintf(stderr, "%s: more than %d words\n", path, MAX_WORDS);
+            fclose(file);
+            return false;
+        }
+        for (int i = 0; i < length; ++i) {
+            char c = line[i];
+            words[word_count][i] = c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+        }
+        words[word_count][length] = '\0';
+        ++word_count;
+    }
+    fclose(file);
+    qsort(words, word_count, MAX_WORD, CompareWords);
+    return true;
+}
+
+static double FalsePositiveRate(const struct BloomFilter *filter) {
+    srand(1);
+    int probes = 0;
+    int positives = 0;
+    while (probes < PROBES) {
+        char probe[PROBE_LENGTH + 1];
+        for (int i = 0; i < PROBE_LENGTH; ++i) {
+            probe[i] = 'a' + rand() % 26;
+        }
+        probe[PROBE_LENGTH] = '\0';
+        if (bsearch(probe, words, word_count, MAX_WORD, CompareWords)) {
+            continue;
+        }
+        ++probes;
+        positives += BloomContains(filter, probe, PROBE_LENGTH);
+    }
+    return (double) positives / probes;
+}
+
+static uint64_t Cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+#endif
+}
+
+static void TimeLongestCheck(struct BloomFilter *filter, uint8_t *bits,
+                             long checks) {
+    char word[LONGEST_CHECKED];
+    for (int i = 0; i < LONGEST_CHECKED; ++i) word[i] = 'a' + i % 26;
+    BloomAdd(filter, bits, word, LONGEST_CHECKED);
+
+    long found = 0;
+    uint64_t start = Cycles();
+    for (long c = 0; c < checks; ++c) {
+        // Keeps the compiler from hoisting the check out of the loop.
+        __asm__ volatile("" : : "r"(word) : "memory");
+        found += BloomContains(filter, word, LONGEST_CHECKED);
+    }
+    uint64_t cycles = Cycles() - start;
+    if (found != checks) {
+        fprintf(stderr, "a word added to the filter was not found\n");
+        exit(1);
+    }
+    printf("%ld checks of a %d letter word, %d hashes: "
+           "%.1f host cycles per check\n", checks, LONGEST_CHECKED,
+           filter->hashes, (double) cycles / checks);
+}
+
+int main(int argc, char **argv) {
+    long bytes = 0;
+    int hashes = DEFAULT_HASHES;
+    long checks = 0;
+    int i = 1;
+    for (; i + 1 < argc && argv[i][0] == '-'; i += 2) {
+        if (!strcmp(argv[i], "-s")) {
+            bytes = atol(argv[i + 1]);
+        } else if (!strcmp(argv[i], "-k")) {
+            hashes = atoi(argv[i + 1]);
+        } else if (!strcmp(argv[i], "-t")) {
+            checks = atol(argv[i + 1]);
+        } else {
+            break;
+        }
+    }
+    if (i + 1 != argc || bytes < 0 || hashes <= 0 || checks < 0) {
+        fprintf(stderr, "usage: %s [-s bytes] [-k hashes] [-t checks] "
+                "words.txt\n", argv[0]);
+        return 2;
+    }
+    if (!LoadWords(argv[i])) return 1;
+    long size = bytes ? bytes : word_count;
+
+    uint8_t *bits = calloc(size, 1);
+    struct BloomFilter filter = {size * 8, hashes, bits};
+    for (int w = 0; w < word_count; ++w) {
+        BloomAdd(&filter, bits, words[w], strlen(words[w]));
+    }
+    if (checks) {
+        TimeLongestCheck(&filter, bits, checks);
+        free(bits);
+        return 0;
+    }
+
+    printf("// Generated by host/spellgen from %d words, do not edit.\n",
+           word_count);
+    printf("#include \"spell_check.h\"\n\n");
+    printf("static const uint8_t bits[%ld] = {", size);
+    for (long b = 0; b < size; ++b) {
+        printf("%s0x%02x,", b % 12 ? " " : "\n    ", bits[b]);
+    }
+    printf("\n};\n\n");
+    printf("const struct BloomFilter spell_dictionary = {%ld, %d, bits};\n",
+           size * 8, hashes);
+
+    fprintf(stderr, "%d words, %ld bytes, %.1f bits per word, %d hashes: "
+            "%.3f%% false positives\n", word_count, size,
+            size * 8.0 / word_count, hashes,
+            100 * FalsePositiveRate(&filter));
+    free(bits);
+    return 0;
+}
@@ -0,0 +1,8 @@
+#ifndef _DELAY_H
+#define _DELAY_H 1
+
+static inline void Delay(unsigned count) {
+    (void) count;
+}
+
+#endif
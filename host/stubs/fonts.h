@@ -0,0 +1,18 @@
+#ifndef _FONTS_H
+#define _FONTS_H 1
+
+#include <stdint.h>
+
+#define FIRST_CHAR ' '
+#define LAST_CHAR  '~'
+
+typedef struct {
+    const uint16_t *table;
+    uint16_t width;
+    uint16_t height;
+} font_t;
+
+// Glyphs of LCD_FONT_WIDTH by LCD_FONT_HEIGHT, see host/hardware.c.
+extern const font_t host_font;
+
+#endif
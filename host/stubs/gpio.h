@@ -0,0 +1,34 @@
+#ifndef _GPIO_H
+#define _GPIO_H 1
+
+#include <stm32.h>
+
+#define GPIO_OType_PP        0
+#define GPIO_Low_Speed       0
+#define GPIO_High_Speed      2
+#define GPIO_PuPd_NOPULL     0
+#define GPIO_PuPd_UP         1
+#define EXTI_Mode_Interrupt  1
+#define EXTI_Trigger_Falling 0
+
+static inline void GPIOoutConfigure(GPIO_TypeDef *gpio, uint32_t pin,
+                                    int otype, int speed, int pupd) {
+    (void) gpio;
+    (void) pin;
+    (void) otype;
+    (void) speed;
+    (void) pupd;
+}
+
+static inline void GPIOinConfigure(GPIO_TypeDef *gpio, uint32_t pin,
+                                   int pupd, int mode, int trigger) {
+    // Rows report presses through EXTI line pin.
+    (void) gpio;
+    (void) pupd;
+    (void) trigger;
+    if (mode == EXTI_Mode_Interrupt) {
+        EXTI->IMR |= 1U << pin;
+    }
+}
+
+#endif
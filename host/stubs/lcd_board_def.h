@@ -0,0 +1,16 @@
+#ifndef _LCD_BOARD_DEF_H
+#define _LCD_BOARD_DEF_H 1
+
+// The keyboard takes port C, so the LCD lines are on A and B.
+#define LCD_CS_GPIO_N   A
+#define LCD_CS_PIN_N    0
+#define LCD_A0_GPIO_N   A
+#define LCD_A0_PIN_N    1
+#define LCD_SDA_GPIO_N  B
+#define LCD_SDA_PIN_N   0
+#define LCD_SCK_GPIO_N  B
+#define LCD_SCK_PIN_N   1
+
+#define LCD_DEFAULT_FONT host_font
+
+#endif
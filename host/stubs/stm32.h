@@ -0,0 +1,88 @@
+#ifndef _STM32_H
+#define _STM32_H 1
+
+// Stand-in for the device header: just the registers the editor
+// uses, backed by host memory, see host/hardware.c.
+
+#include <stdint.h>
+
+#define xcat(a, b) xcat_(a, b)
+#define xcat_(a, b) a##b
+#define xcat3(a, b, c) xcat3_(a, b, c)
+#define xcat3_(a, b, c) a##b##c
+
+#define MAIN_CLOCK_MHZ 16
+
+typedef struct {
+    volatile uint32_t IDR;
+    volatile uint16_t BSRRL;
+    volatile uint16_t BSRRH;
+} GPIO_TypeDef;
+
+typedef struct {
+    volatile uint32_t AHB1ENR;
+    volatile uint32_t APB1ENR;
+    volatile uint32_t APB2ENR;
+} RCC_TypeDef;
+
+typedef struct {
+    volatile uint32_t IMR;
+    volatile uint32_t PR;
+} EXTI_TypeDef;
+
+typedef struct {
+    volatile uint32_t CR1;
+    volatile uint32_t ARR;
+    volatile uint32_t PSC;
+    volatile uint32_t EGR;
+    volatile uint32_t DIER;
+    volatile uint32_t SR;
+    volatile uint32_t CNT;
+} TIM_TypeDef;
+
+// Every port access goes through HostGpio, which first applies the
+// previous write to a set/reset register, so the stand-in hardware
+// sees each pin change in order.
+GPIO_TypeDef *HostGpio(int port);
+
+#define GPIOA (HostGpio(0))
+#define GPIOB (HostGpio(1))
+#define GPIOC (HostGpio(2))
+
+extern RCC_TypeDef host_rcc;
+extern EXTI_TypeDef host_exti;
+extern TIM_TypeDef host_tim3;
+
+#define RCC (&host_rcc)
+#define EXTI (&host_exti)
+#define TIM3 (&host_tim3)
+
+#define RCC_AHB1ENR_GPIOAEN  (1U << 0)
+#define RCC_AHB1ENR_GPIOBEN  (1U << 1)
+#define RCC_AHB1ENR_GPIOCEN  (1U << 2)
+#define RCC_APB1ENR_TIM3EN   (1U << 1)
+#define RCC_APB2ENR_SYSCFGEN (1U << 14)
+
+#define TIM_CR1_CEN  (1U << 0)
+#define TIM_DIER_UIE (1U << 0)
+#define TIM_SR_UIF   (1U << 0)
+#define TIM_EGR_UG   (1U << 0)
+
+typedef enum {
+    EXTI9_5_IRQn = 23,
+    TIM3_IRQn = 29,
+} IRQn_Type;
+
+static inline void NVIC_SetPriority(IRQn_Type irq, uint32_t priority) {
+    (void) irq;
+    (void) priority;
+}
+
+static inline void NVIC_EnableIRQ(IRQn_Type irq) {
+    (void) irq;
+}
+
+static inline void __NOP(void) {
+}
+
+#endif
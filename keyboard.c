@@ -6,6 +6,12 @@
 #define SCAN_NOP_COUNT 10
 // Button will be fixed after 100 ticks which makes 1 second.
 #define TICKS_TO_FIX_BUTTON 100
+// A held button starts repeating after 50 ticks, first every 20 ticks,
+// then 2 ticks sooner each time, down to every 4 ticks.
+#define TICKS_TO_HOLD 50
+#define REPEAT_INTERVAL_START 20
+#define REPEAT_INTERVAL_MIN 4
+#define REPEAT_ACCELERATION 2
 
 // Populated by ScanKeyboard: what has been pressed on the
 // keyboard.
@@ -26,7 +32,15 @@ int tick_count = 0;
 // 1 means additionaly count ticks to fix button after some delay.
 int counter_mode = 0;
 
+// Auto-repeat state of the currently held button.
+int held_row;
+int held_col;
+int hold_ticks = 0;
+int hold_interval = TICKS_TO_HOLD;
+int hold_repeat = 0;
+
 void ButtonClick(void);
+void ButtonHold(void);
 void ScanKeyboard(void);
 
 void KeyboardConfigure(void) {
@@ -132,14 +146,25 @@ void ButtonClick(void) {
     }
 
     else {
-        if (current_press_recorded) return;
+        if (current_press_recorded) {
+            ButtonHold();
+            return;
+        }
 
         // start over the counter
         tick_count = 0;
 
         current_press_recorded = true;
+        held_row = row_pressed;
+        held_col = col_pressed;
+        hold_ticks = 0;
+        hold_interval = TICKS_TO_HOLD;
+        hold_repeat = 0;
 
         if (two_pressed) {
+            // No key was received, so none may repeat, even when
+            // the others are released and one stays held.
+            held_row = -1;
             AmbiguousPress();
         } else if(any_pressed) {
             ButtonPressed(row_pressed, col_pressed);
@@ -147,6 +172,25 @@ void ButtonClick(void) {
     }
 }
 
+void ButtonHold(void) {
+    // Only a single, unchanged button auto-repeats.
+    if (two_pressed || row_pressed != held_row || col_pressed != held_col) {
+        return;
+    }
+    if (++hold_ticks < hold_interval) return;
+    hold_ticks = 0;
+
+    ButtonHeld(held_row, held_col, hold_repeat);
+
+    // Accelerate.
+    if (hold_repeat == 0) {
+        hold_interval = REPEAT_INTERVAL_START;
+    } else if (hold_interval - REPEAT_ACCELERATION >= REPEAT_INTERVAL_MIN) {
+        hold_interval -= REPEAT_ACCELERATION;
+    }
+    hold_repeat++;
+}
+
 // Row interrupt.
 void EXTI9_5_IRQHandler(void) {
 
@@ -5,6 +5,9 @@
 void ButtonPressed(int row_pressed, int col_pressed);
 void FixButton(void);
 void AmbiguousPress(void);
+// Called repeatedly while a single button stays pressed, with
+// a growing repeat number and an accelerating rate.
+void ButtonHeld(int row_pressed, int col_pressed, int repeat);
 
 // Delivered by keyboard.c:
 void KeyboardConfigure(void);
@@ -3,6 +3,7 @@
 #include <gpio.h>
 #include <lcd.h>
 #include <lcd_board_def.h>
+#include "lcd_geometry.h"
 
 /** The simple LCD driver (only text mode) for ST7735S controller
     and STM32F2xx or STM32F4xx **/
@@ -28,24 +29,6 @@ constants PIN_LCD_* and RCC_LCD_* are bit masks. */
 #define RCC_LCD_SDA   xcat3(RCC_AHB1ENR_GPIO, LCD_SDA_GPIO_N, EN)
 #define RCC_LCD_SCK   xcat3(RCC_AHB1ENR_GPIO, LCD_SCK_GPIO_N, EN)
 
-/* Screen size in pixels, left top corner has coordinates (0, 0). */
-
-#define LCD_PIXEL_WIDTH   128
-#define LCD_PIXEL_HEIGHT  160
-
-/* Some color definitions */
-
-#define LCD_COLOR_WHITE    0xFFFF
-#define LCD_COLOR_BLACK    0x0000
-#define LCD_COLOR_GREY     0xF7DE
-#define LCD_COLOR_BLUE     0x001F
-#define LCD_COLOR_BLUE2    0x051F
-#define LCD_COLOR_RED      0xF800
-#define LCD_COLOR_MAGENTA  0xF81F
-#define LCD_COLOR_GREEN    0x07E0
-#define LCD_COLOR_CYAN     0x7FFF
-#define LCD_COLOR_YELLOW   0xFFE0
-
 /* Needed delay(s)  */
 
 #define Tinit   150
@@ -53,15 +36,12 @@ constants PIN_LCD_* and RCC_LCD_* are bit masks. */
 
 /* Text mode globals */
 
-static const font_t *CurrentFont;
 static uint16_t TextColor = LCD_COLOR_BLACK;
 static uint16_t BackColor = LCD_COLOR_WHITE;
 
-/* Current character line and position, the number of lines, the
-number of characters in a line, position 0 and line 0 offset on screen
-in pixels */
+/* Current character line and position */
 
-static int Line, Position, TextHeight, TextWidth, XOffset, YOffset;
+static int Line, Position;
 
 /** Internal functions **/
 
@@ -245,34 +225,120 @@ static void LCDcontrollerConfigure(void) {
   CS(1);
 }
 
-static void LCDsetFont(const font_t *font) {
-  CurrentFont = font;
-  TextHeight = LCD_PIXEL_HEIGHT / CurrentFont->height;
-  TextWidth  = LCD_PIXEL_WIDTH  / CurrentFont->width;
-  XOffset = (LCD_PIXEL_WIDTH  - TextWidth  * CurrentFont->width)  / 2;
-  YOffset = (LCD_PIXEL_HEIGHT - TextHeight * CurrentFont->height) / 2;
-}
-
 static void LCDsetColors(uint16_t text, uint16_t back) {
   TextColor = text;
   BackColor = back;
 }
 
-static void LCDdrawChar(unsigned c) {
+/* The glyph kernel is unrolled for the font size, so the bit tests
+and the rectangle corners are constants. LCD_REPEAT(n, m) expands
+to m(0) m(1) ... m(n - 1). */
+
+#define LCD_REPEAT(n, m) LCD_REPEAT_(n, m)
+#define LCD_REPEAT_(n, m) LCD_REPEAT_##n(m)
+#define LCD_REPEAT_1(m)  m(0)
+#define LCD_REPEAT_2(m)  LCD_REPEAT_1(m)  m(1)
+#define LCD_REPEAT_3(m)  LCD_REPEAT_2(m)  m(2)
+#define LCD_REPEAT_4(m)  LCD_REPEAT_3(m)  m(3)
+#define LCD_REPEAT_5(m)  LCD_REPEAT_4(m)  m(4)
+#define LCD_REPEAT_6(m)  LCD_REPEAT_5(m)  m(5)
+#define LCD_REPEAT_7(m)  LCD_REPEAT_6(m)  m(6)
+#define LCD_REPEAT_8(m)  LCD_REPEAT_7(m)  m(7)
+#define LCD_REPEAT_9(m)  LCD_REPEAT_8(m)  m(8)
+#define LCD_REPEAT_10(m) LCD_REPEAT_9(m)  m(9)
+#define LCD_REPEAT_11(m) LCD_REPEAT_10(m) m(10)
+#define LCD_REPEAT_12(m) LCD_REPEAT_11(m) m(11)
+#define LCD_REPEAT_13(m) LCD_REPEAT_12(m) m(12)
+#define LCD_REPEAT_14(m) LCD_REPEAT_13(m) m(13)
+#define LCD_REPEAT_15(m) LCD_REPEAT_14(m) m(14)
+#define LCD_REPEAT_16(m) LCD_REPEAT_15(m) m(15)
+#define LCD_REPEAT_17(m) LCD_REPEAT_16(m) m(16)
+#define LCD_REPEAT_18(m) LCD_REPEAT_17(m) m(17)
+#define LCD_REPEAT_19(m) LCD_REPEAT_18(m) m(18)
+#define LCD_REPEAT_20(m) LCD_REPEAT_19(m) m(19)
+#define LCD_REPEAT_21(m) LCD_REPEAT_20(m) m(20)
+#define LCD_REPEAT_22(m) LCD_REPEAT_21(m) m(21)
+#define LCD_REPEAT_23(m) LCD_REPEAT_22(m) m(22)
+#define LCD_REPEAT_24(m) LCD_REPEAT_23(m) m(23)
+#define LCD_REPEAT_25(m) LCD_REPEAT_24(m) m(24)
+#define LCD_REPEAT_26(m) LCD_REPEAT_25(m) m(25)
+#define LCD_REPEAT_27(m) LCD_REPEAT_26(m) m(26)
+#define LCD_REPEAT_28(m) LCD_REPEAT_27(m) m(27)
+#define LCD_REPEAT_29(m) LCD_REPEAT_28(m) m(28)
+#define LCD_REPEAT_30(m) LCD_REPEAT_29(m) m(29)
+#define LCD_REPEAT_31(m) LCD_REPEAT_30(m) m(30)
+#define LCD_REPEAT_32(m) LCD_REPEAT_31(m) m(31)
+
+#define LCD_GLYPH_PIXEL(j) LCDwriteData16(w & (1U << (j)) ? text : back);
+#define LCD_GLYPH_ROW(i)   LCDdrawGlyphRow(p[i], text, back);
+/* A pixel row across a run of glyphs, the last one as a line
+if underlined. */
+#define LCD_RUN_ROW(i)                                              \
+  for (k = 0; k < count; ++k)                                       \
+    LCDdrawGlyphRow(underline && (i) == LCD_FONT_HEIGHT - 1 ?       \
+                    0xFFFF : p[k][i], text, back);
+
+#ifndef LCD_GENERIC_KERNEL
+
+#define LCD_GLYPH_ROWS(m) LCD_REPEAT(LCD_FONT_HEIGHT, m)
+
+static inline void LCDdrawGlyphRow(uint32_t w, uint16_t text,
+                                   uint16_t back) {
+  LCD_REPEAT(LCD_FONT_WIDTH, LCD_GLYPH_PIXEL)
+}
+
+#else
+
+/* The kernel as it was before unrolling, looping over the glyph
+size of the font at run time, for host/glyphbench to compare. */
+
+static const font_t *CurrentFont = &LCD_FONT;
+
+#define LCD_GLYPH_ROWS(m)                                           \
+  {                                                                 \
+    int i;                                                          \
+    for (i = 0; i < CurrentFont->height; ++i) {                     \
+      m(i)                                                          \
+    }                                                               \
+  }
+
+static inline void LCDdrawGlyphRow(uint32_t w, uint16_t text,
+                                   uint16_t back) {
+  int j;
+
+  for (j = 0; j < CurrentFont->width; ++j, w >>= 1) {
+    LCDwriteData16(w & 1 ? text : back);
+  }
+}
+
+#endif
+
+static void LCDdrawChar(unsigned c, uint16_t text, uint16_t back) {
   uint16_t const *p;
-  uint16_t x, y, w;
-  int      i, j;
+  uint16_t x, y;
 
   CS(0);
-  y = YOffset + CurrentFont->height * Line;
-  x = XOffset + CurrentFont->width  * Position;
-  LCDsetRectangle(x, y, x + CurrentFont->width - 1, y + CurrentFont->height - 1);
-  p = &CurrentFont->table[(c - FIRST_CHAR) * CurrentFont->height];
-  for (i = 0; i < CurrentFont->height; ++i) {
-    for (j = 0, w = p[i]; j < CurrentFont->width; ++j, w >>= 1) {
-      LCDwriteData16(w & 1 ? TextColor : BackColor);
-    }
-  }
+  y = LCD_Y_OFFSET + LCD_FONT_HEIGHT * Line;
+  x = LCD_X_OFFSET + LCD_FONT_WIDTH  * Position;
+  LCDsetRectangle(x, y, x + LCD_FONT_WIDTH - 1, y + LCD_FONT_HEIGHT - 1);
+  p = &LCD_FONT.table[(c - FIRST_CHAR) * LCD_FONT_HEIGHT];
+  LCD_GLYPH_ROWS(LCD_GLYPH_ROW)
+  CS(1);
+}
+
+/* Draws count glyphs side by side in a single window, so that
+the window is set once for the run. */
+static void LCDdrawRun(uint16_t const *const *p, int count,
+                       uint16_t text, uint16_t back, int underline) {
+  uint16_t x, y;
+  int k;
+
+  CS(0);
+  y = LCD_Y_OFFSET + LCD_FONT_HEIGHT * Line;
+  x = LCD_X_OFFSET + LCD_FONT_WIDTH  * Position;
+  LCDsetRectangle(x, y, x + LCD_FONT_WIDTH * count - 1,
+                  y + LCD_FONT_HEIGHT - 1);
+  LCD_GLYPH_ROWS(LCD_RUN_ROW)
   CS(1);
 }
 
@@ -282,11 +348,20 @@ void LCDconfigure() {
   /* See Errata, 2.1.6 Delay after an RCC peripheral clock enabling */
   RCCconfigure();
   /* Initialize global variables. */
-  LCDsetFont(&LCD_DEFAULT_FONT);
   LCDsetColors(LCD_COLOR_WHITE, LCD_COLOR_BLUE);
   /* Initialize hardware. */
   GPIOconfigure();
   LCDcontrollerConfigure();
+  /* The kernels are unrolled for the glyph size of lcd_geometry.h,
+     which fonts.c, outside of the tree, cannot check at compile time.
+     Rather than draw garbage with another font, stop on a red screen. */
+  if (LCD_FONT.width != LCD_FONT_WIDTH ||
+      LCD_FONT.height != LCD_FONT_HEIGHT) {
+    LCDsetColors(LCD_COLOR_WHITE, LCD_COLOR_RED);
+    LCDclear();
+    for (;;) {
+    }
+  }
   LCDclear();
 }
 
@@ -319,9 +394,9 @@ void LCDputchar(char c) {
     LCDgoto(Line, (Position + 8) & ~7); /* tabulator */
   else {
     if (c >= FIRST_CHAR && c <= LAST_CHAR &&
-        Line >= 0 && Line < TextHeight &&
-        Position >= 0 && Position < TextWidth) {
-      LCDdrawChar(c);
+        Line >= 0 && Line < LCD_TEXT_HEIGHT &&
+        Position >= 0 && Position < LCD_TEXT_WIDTH) {
+      LCDdrawChar(c, TextColor, BackColor);
     }
     LCDgoto(Line, Position + 1);
   }
@@ -330,7 +405,7 @@ void LCDputchar(char c) {
 void LCDputcharWrap(char c) {
   /* Check if, there is room for the next character,
   but does not wrap on white character. */
-  if (Position >= TextWidth &&
+  if (Position >= LCD_TEXT_WIDTH &&
       c != '\t' && c != '\r' &&  c != '\n' && c != ' ') {
     LCDputchar('\n');
   }
@@ -341,10 +416,46 @@ void LCDbackspace(void) {
     if (Position >= 1) {
         LCDgoto(Line, Position - 1);
     } else if (Line > 0) {
-        LCDgoto(Line - 1, TextWidth - 1);
+        LCDgoto(Line - 1, LCD_TEXT_WIDTH - 1);
     }
-    if (Line >= 0 && Line < TextHeight &&
-        Position >= 0 && Position < TextWidth) {
-      LCDdrawChar(' ');
+    if (Line >= 0 && Line < LCD_TEXT_HEIGHT &&
+        Position >= 0 && Position < LCD_TEXT_WIDTH) {
+      LCDdrawChar(' ', TextColor, BackColor);
+    }
+}
+
+void LCDputchars(const char *s, int count, uint16_t text, uint16_t back,
+                 int underline) {
+    uint16_t const *p[LCD_TEXT_WIDTH];
+    int k;
+
+    if (count > LCD_TEXT_WIDTH - Position) {
+        count = LCD_TEXT_WIDTH - Position;
+    }
+    if (count > 0 && Line >= 0 && Line < LCD_TEXT_HEIGHT && Position >= 0) {
+        for (k = 0; k < count; ++k) {
+            char c = s[k] >= FIRST_CHAR && s[k] <= LAST_CHAR ? s[k] : ' ';
+            p[k] = &LCD_FONT.table[(c - FIRST_CHAR) * LCD_FONT_HEIGHT];
+        }
+        LCDdrawRun(p, count, text, back, underline);
+    }
+    LCDgoto(Line, Position + count);
+}
+
+void LCDunderline(char c, int on, uint16_t text, uint16_t back) {
+    uint16_t x, y;
+
+    if (c < FIRST_CHAR || c > LAST_CHAR ||
+        Line < 0 || Line >= LCD_TEXT_HEIGHT ||
+        Position < 0 || Position >= LCD_TEXT_WIDTH) {
+        return;
     }
+    CS(0);
+    y = LCD_Y_OFFSET + LCD_FONT_HEIGHT * Line + LCD_FONT_HEIGHT - 1;
+    x = LCD_X_OFFSET + LCD_FONT_WIDTH  * Position;
+    LCDsetRectangle(x, y, x + LCD_FONT_WIDTH - 1, y);
+    LCDdrawGlyphRow(on ? 0xFFFF : LCD_FONT.table[(c - FIRST_CHAR + 1) *
+                                                 LCD_FONT_HEIGHT - 1],
+                    text, back);
+    CS(1);
 }
@@ -1,11 +1,33 @@
 #ifndef _LCD_H
 #define _LCD_H 1
 
+#include <stdint.h>
+
+/* Some color definitions */
+
+#define LCD_COLOR_WHITE    0xFFFF
+#define LCD_COLOR_BLACK    0x0000
+#define LCD_COLOR_GREY     0xF7DE
+#define LCD_COLOR_BLUE     0x001F
+#define LCD_COLOR_BLUE2    0x051F
+#define LCD_COLOR_RED      0xF800
+#define LCD_COLOR_MAGENTA  0xF81F
+#define LCD_COLOR_GREEN    0x07E0
+#define LCD_COLOR_CYAN     0x7FFF
+#define LCD_COLOR_YELLOW   0xFFE0
+
 void LCDconfigure(void);
 void LCDclear(void);
 void LCDgoto(int textLine, int charPos);
 void LCDputchar(char c);
 void LCDputcharWrap(char c);
 void LCDbackspace(void);
+// Draws count characters from the current position on, in the given
+// colours and in a single window, and moves past them. Does not wrap.
+void LCDputchars(const char *s, int count, uint16_t text, uint16_t back,
+                 int underline);
+// Redraws the bottom pixel row of the character c at the current
+// position, as a line or as that row of the glyph.
+void LCDunderline(char c, int on, uint16_t text, uint16_t back);
 
 #endif
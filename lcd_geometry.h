@@ -0,0 +1,39 @@
+#ifndef _LCD_GEOMETRY_H
+#define _LCD_GEOMETRY_H 1
+
+// Screen size in pixels, left top corner has coordinates (0, 0).
+#define LCD_PIXEL_WIDTH   128
+#define LCD_PIXEL_HEIGHT  160
+
+// The font text is drawn with. Its glyph size is fixed at compile
+// time: the drawing kernel is unrolled for it and the text grid
+// follows from it. To use another font of fonts.h, define all three
+// macros, e.g. in CPPFLAGS.
+// The size of a font is only known to fonts.c, outside of the tree,
+// so LCD_FONT_WIDTH and LCD_FONT_HEIGHT cannot be checked against it
+// at compile time. LCDconfigure checks them instead and stops with a
+// red screen if they differ.
+#ifndef LCD_FONT
+#define LCD_FONT          LCD_DEFAULT_FONT
+#define LCD_FONT_WIDTH    14
+#define LCD_FONT_HEIGHT   28
+#elif !defined(LCD_FONT_WIDTH) || !defined(LCD_FONT_HEIGHT)
+#error "LCD_FONT needs LCD_FONT_WIDTH and LCD_FONT_HEIGHT"
+#endif
+
+// The text grid, centred on the screen.
+#define LCD_TEXT_WIDTH    (LCD_PIXEL_WIDTH  / LCD_FONT_WIDTH)
+#define LCD_TEXT_HEIGHT   (LCD_PIXEL_HEIGHT / LCD_FONT_HEIGHT)
+#define LCD_X_OFFSET      ((LCD_PIXEL_WIDTH  - LCD_TEXT_WIDTH  * LCD_FONT_WIDTH)  / 2)
+#define LCD_Y_OFFSET      ((LCD_PIXEL_HEIGHT - LCD_TEXT_HEIGHT * LCD_FONT_HEIGHT) / 2)
+
+// Glyph rows are 16-bit words, and the kernel is unrolled
+// for at most 32 rows.
+_Static_assert(LCD_FONT_WIDTH >= 1 && LCD_FONT_WIDTH <= 16,
+               "font width must be 1 to 16 pixels");
+_Static_assert(LCD_FONT_HEIGHT >= 1 && LCD_FONT_HEIGHT <= 32,
+               "font height must be 1 to 32 pixels");
+_Static_assert(LCD_TEXT_WIDTH >= 1 && LCD_TEXT_HEIGHT >= 1,
+               "font larger than the screen");
+
+#endif
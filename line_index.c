@@ -0,0 +1,176 @@
+#include "line_index.h"
+
+static int Rows(const struct LineIndex *index, int length) {
+    return length / index->width + 1;
+}
+
+static struct LineEntry Entry(const struct LineIndex *index, int line) {
+    if (line < index->gap_start) return index->lines[line];
+    struct LineEntry entry =
+        index->lines[line + index->gap_end - index->gap_start];
+    entry.start += index->length;
+    entry.row += index->row_count;
+    return entry;
+}
+
+static int LineEnd(const struct LineIndex *index, int line) {
+    // The position of the newline ending the line, or the text end.
+    return line + 1 < LineIndexLineCount(index)
+        ? Entry(index, line + 1).start - 1 : index->length;
+}
+
+static int LineLength(const struct LineIndex *index, int line) {
+    return LineEnd(index, line) - Entry(index, line).start;
+}
+
+static void MoveGap(struct LineIndex *index, int line) {
+    // Moves the gap to before the given line, converting the entries
+    // that cross it.
+    while (index->gap_start < line) {
+        struct LineEntry entry = index->lines[index->gap_end++];
+        entry.start += index->length;
+        entry.row += index->row_count;
+        index->lines[index->gap_start++] = entry;
+    }
+    while (index->gap_start > line) {
+        struct LineEntry entry = index->lines[--index->gap_start];
+        entry.start -= index->length;
+        entry.row -= index->row_count;
+        index->lines[--index->gap_end] = entry;
+    }
+}
+
+static int LineOf(const struct LineIndex *index, int position) {
+    // The last line starting at or before the position.
+    int low = 0;
+    int high = LineIndexLineCount(index) - 1;
+    while (low < high) {
+        int middle = (low + high + 1) / 2;
+        if (Entry(index, middle).start <= position) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
+
+static int LineOfRow(const struct LineIndex *index, int row) {
+    // The last line starting at or before the row.
+    int low = 0;
+    int high = LineIndexLineCount(index) - 1;
+    while (low < high) {
+        int middle = (low + high + 1) / 2;
+        if (Entry(index, middle).row <= row) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+    return low;
+}
+
+void LineIndexClear(struct LineIndex *index, int width) {
+    index->lines[0].start = 0;
+    index->lines[0].row = 0;
+    index->gap_start = 1;
+    index->gap_end = LINE_INDEX_MAX_LINES;
+    index->width = width;
+    index->length = 0;
+    index->row_count = 1;
+}
+
+int LineIndexLineCount(const struct LineIndex *index) {
+    return index->gap_start + LINE_INDEX_MAX_LINES - index->gap_end;
+}
+
+int LineIndexRowCount(const struct LineIndex *index) {
+    return index->row_count;
+}
+
+bool LineIndexCanInsert(const struct LineIndex *index, int newlines) {
+    return LineIndexLineCount(index) + newlines <= LINE_INDEX_MAX_LINES;
+}
+
+static void Insert(struct LineIndex *index, int position, int count,
+                   const char *text, const int32_t *newlines,
+                   int newline_count) {
+    // The inserted newlines split the line of the position, the
+    // entries after the gap stay as they are. They are those of the
+    // text, or given by their offsets if it is NULL.
+    int line = LineOf(index, position);
+    MoveGap(index, line + 1);
+    int old_rows = Rows(index, LineLength(index, line));
+    index->length += count;
+    int first_row = index->lines[line].row;
+    int row = first_row;
+    int start = index->lines[line].start;
+    for (int i = 0; i < (text ? count : newline_count); ++i) {
+        int offset = text ? i : newlines[i];
+        if (text && text[i] != '\n') continue;
+        row += Rows(index, position + offset - start);
+        start = position + offset + 1;
+        index->lines[index->gap_start].start = start;
+        index->lines[index->gap_start].row = row;
+        ++index->gap_start;
+    }
+    row += Rows(index, LineEnd(index, index->gap_start - 1) - start);
+    index->row_count += row - first_row - old_rows;
+}
+
+void LineIndexInsert(struct LineIndex *index, int position,
+                     const char *text, int count) {
+    Insert(index, position, count, text, 0, 0);
+}
+
+void LineIndexInsertNewlines(struct LineIndex *index, int position,
+                             int count, const int32_t *newlines,
+                             int newline_count) {
+    Insert(index, position, count, 0, newlines, newline_count);
+}
+
+int LineIndexNewlines(const struct LineIndex *index, int position,
+                      int count, int32_t *newlines) {
+    // Each line after the one of the position starts past a newline.
+    int newline_count = 0;
+    int line_count = LineIndexLineCount(index);
+    for (int line = LineOf(index, position) + 1; line < line_count; ++line) {
+        int newline = Entry(index, line).start - 1;
+        if (newline >= position + count) break;
+        newlines[newline_count++] = newline - position;
+    }
+    return newline_count;
+}
+
+void LineIndexDelete(struct LineIndex *index, int position, int count) {
+    // The lines whose newline is deleted join the line of the
+    // position.
+    int first = LineOf(index, position);
+    int last = LineOf(index, position + count);
+    int old_rows = Entry(index, last).row - Entry(index, first).row +
+                   Rows(index, LineLength(index, last));
+    MoveGap(index, last + 1);
+    index->gap_start = first + 1;
+    index->length -= count;
+    index->row_count += Rows(index, LineLength(index, first)) - old_rows;
+}
+
+int LineIndexRowOf(const struct LineIndex *index, int position, int *col) {
+    struct LineEntry entry = Entry(index, LineOf(index, position));
+    int offset = position - entry.start;
+    *col = offset % index->width;
+    return entry.row + offset / index->width;
+}
+
+int LineIndexRowStart(const struct LineIndex *index, int row, int *length) {
+    if (row < 0 || row >= index->row_count) {
+        *length = 0;
+        return -1;
+    }
+    int line = LineOfRow(index, row);
+    struct LineEntry entry = Entry(index, line);
+    int offset = (row - entry.row) * index->width;
+    int rest = LineLength(index, line) - offset;
+    *length = rest < index->width ? rest : index->width;
+    return entry.start + offset;
+}
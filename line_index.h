@@ -0,0 +1,64 @@
+#ifndef _LINE_INDEX_H
+#define _LINE_INDEX_H 1
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Where the lines of a text start, and on which screen row, with
+// lines wrapped at a fixed width. A line of n characters takes
+// n / width + 1 rows, so that the cursor after its last character
+// is on the screen too.
+#ifndef LINE_INDEX_MAX_LINES
+#define LINE_INDEX_MAX_LINES 2048
+#endif
+
+struct LineEntry {
+    int32_t start;
+    int32_t row;
+};
+
+// The entries are kept in order with a gap at the last edited line.
+// Lines before the gap count from the start of the text, lines after
+// it from the end, so an edit updates the entries of the lines it
+// touches only. Moving the gap costs the distance in lines, and
+// lookups are binary searches.
+struct LineIndex {
+    struct LineEntry lines[LINE_INDEX_MAX_LINES];
+    int gap_start;
+    int gap_end;
+    int width;
+    int length;
+    int row_count;
+};
+
+// Empty text, a single line.
+void LineIndexClear(struct LineIndex *index, int width);
+int LineIndexLineCount(const struct LineIndex *index);
+int LineIndexRowCount(const struct LineIndex *index);
+// Whether that many more lines fit.
+bool LineIndexCanInsert(const struct LineIndex *index, int newlines);
+
+// Update the index after the text changed. The newlines of the
+// inserted text must fit, see LineIndexCanInsert.
+void LineIndexInsert(struct LineIndex *index, int position,
+                     const char *text, int count);
+void LineIndexDelete(struct LineIndex *index, int position, int count);
+// As LineIndexInsert, for text whose newlines are known: they are at
+// the given offsets into it, in order, e.g. from LineIndexNewlines.
+void LineIndexInsertNewlines(struct LineIndex *index, int position,
+                             int count, const int32_t *newlines,
+                             int newline_count);
+// Stores the offsets of the newlines of count characters from the
+// position, relative to it, and returns how many there are. Costs
+// a lookup and then a step per newline, not per character.
+int LineIndexNewlines(const struct LineIndex *index, int position,
+                      int count, int32_t *newlines);
+
+// The row and column of a position. The rows from the one of an
+// edited position on are the ones the edit may change.
+int LineIndexRowOf(const struct LineIndex *index, int position, int *col);
+// The position of the first character of a row and the number of
+// characters on it, without the newline. Returns -1 past the text.
+int LineIndexRowStart(const struct LineIndex *index, int row, int *length);
+
+#endif
@@ -0,0 +1,59 @@
+#include "packed_text.h"
+
+#define SYMBOL_MASK ((1 << PACKED_BITS) - 1)
+
+// Symbol codes, in order. Codes past the end decode as '?'.
+static const char alphabet[] =
+    " abcdefghijklmnopqrstuvwxyz0123456789*#\n";
+#define ALPHABET_SIZE ((int) sizeof(alphabet) - 1)
+
+static unsigned Encode(char c) {
+    if (c >= 'a' && c <= 'z') return c - 'a' + 1;
+    if (c >= '0' && c <= '9') return c - '0' + 27;
+    if (c == ' ') return 0;
+    if (c == '*') return 37;
+    if (c == '#') return 38;
+    if (c == '\n') return 39;
+    return SYMBOL_MASK;
+}
+
+static char Decode(unsigned code) {
+    return code < ALPHABET_SIZE ? alphabet[code] : '?';
+}
+
+char PackedGet(const uint8_t *packed, int index) {
+    int bit = index * PACKED_BITS;
+    const uint8_t *p = &packed[bit >> 3];
+    unsigned word = p[0] | p[1] << 8;
+    return Decode((word >> (bit & 7)) & SYMBOL_MASK);
+}
+
+void PackedSet(uint8_t *packed, int index, char c) {
+    int bit = index * PACKED_BITS;
+    uint8_t *p = &packed[bit >> 3];
+    unsigned shift = bit & 7;
+    unsigned word = p[0] | p[1] << 8;
+    word &= ~(SYMBOL_MASK << shift);
+    word |= Encode(c) << shift;
+    p[0] = word;
+    p[1] = word >> 8;
+}
+
+void PackedRead(const uint8_t *packed, int index, int count, char *out) {
+    // Single symbols up to a group border, then whole groups.
+    for (; count > 0 && index % 4; --count) {
+        *out++ = PackedGet(packed, index++);
+    }
+    const uint8_t *p = &packed[index / 4 * 3];
+    for (; count >= 4; count -= 4, index += 4, p += 3) {
+        uint32_t group = p[0] | p[1] << 8 | (uint32_t) p[2] << 16;
+        out[0] = Decode(group & SYMBOL_MASK);
+        out[1] = Decode((group >> 6) & SYMBOL_MASK);
+        out[2] = Decode((group >> 12) & SYMBOL_MASK);
+        out[3] = Decode(group >> 18);
+        out += 4;
+    }
+    for (; count > 0; --count) {
+        *out++ = PackedGet(packed, index++);
+    }
+}
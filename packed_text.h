@@ -0,0 +1,21 @@
+#ifndef _PACKED_TEXT_H
+#define _PACKED_TEXT_H 1
+
+#include <stdint.h>
+
+// The keypad alphabet fits in 6 bits, so text is stored as
+// 4 symbols in 3 bytes.
+#define PACKED_BITS 6
+// Bytes needed for count symbols. One spare byte lets every
+// symbol be read with a single 16-bit load.
+#define PACKED_SIZE(count) (((count) * PACKED_BITS + 7) / 8 + 1)
+// Symbols that fit in the given number of bytes.
+#define PACKED_CAPACITY(bytes) (((bytes) - 1) * 8 / PACKED_BITS)
+
+// Characters outside of the alphabet are stored as '?'.
+char PackedGet(const uint8_t *packed, int index);
+void PackedSet(uint8_t *packed, int index, char c);
+// Unpacks count symbols, a whole group of 4 at a time.
+void PackedRead(const uint8_t *packed, int index, int count, char *out);
+
+#endif
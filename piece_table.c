@@ -0,0 +1,388 @@
+#include <string.h>
+#include "piece_table.h"
+
+// Chunks kept free for PieceTableCollect.
+#define CHUNK_RESERVE 1
+
+// The first shared_symbols[c] symbols of chunk c may be referred to
+// by more than one piece, so they are never overwritten in place.
+static uint16_t shared_symbols[POOL_CHUNKS];
+
+static int ChunkOf(const struct Piece *piece) {
+    return piece->start / CHUNK_SYMBOLS;
+}
+
+void PieceTableClear(struct PieceTable *table) {
+    for (int k = 0; k < table->piece_count; ++k) {
+        ChunkRelease(ChunkOf(&table->pieces[k]), table->pieces[k].length);
+    }
+    if (table->append_fill) {
+        ChunkRelease(table->append_chunk, 1);
+    }
+    table->piece_count = 0;
+    table->length = 0;
+    table->cache_piece = 0;
+    table->cache_start = 0;
+    table->window_length = 0;
+    table->append_fill = 0;
+}
+
+static int Locate(struct PieceTable *table, int position, int *offset) {
+    // Finds the piece containing the position. A position on the border
+    // of two pieces belongs to the latter, the end of the text
+    // to piece_count.
+    // Edits keep the start of the cached piece valid: they only change
+    // the pieces after it, or the cached piece at its end.
+    int k = table->cache_piece;
+    int start = table->cache_start;
+    while (k > 0 && position < start) {
+        --k;
+        start -= table->pieces[k].length;
+    }
+    while (k < table->piece_count &&
+           position >= start + table->pieces[k].length) {
+        start += table->pieces[k].length;
+        ++k;
+    }
+    table->cache_piece = k;
+    table->cache_start = start;
+    *offset = position - start;
+    return k;
+}
+
+static void ShiftPieces(struct PieceTable *table, int k, int delta) {
+    // Moves the pieces from k on by delta places.
+    memmove(&table->pieces[k + delta], &table->pieces[k],
+            (table->piece_count - k) * sizeof(struct Piece));
+    table->piece_count += delta;
+}
+
+static void Split(struct PieceTable *table, int k, int offset) {
+    // Splits piece k at the offset, the right part becomes piece k + 1.
+    ShiftPieces(table, k + 1, 1);
+    table->pieces[k + 1].start = table->pieces[k].start + offset;
+    table->pieces[k + 1].length = table->pieces[k].length - offset;
+    table->pieces[k].length = offset;
+}
+
+static bool AppendFits(const struct PieceTable *table, int count) {
+    return table->append_fill && table->append_fill + count <= CHUNK_SYMBOLS;
+}
+
+static bool AppendRoom(const struct PieceTable *table, int count) {
+    // Can count symbols be appended next to each other?
+    return AppendFits(table, count) || ChunkFreeCount() > CHUNK_RESERVE;
+}
+
+static void AppendStart(struct PieceTable *table, int count) {
+    // Takes a new append chunk if count symbols do not fit in the
+    // current one. Requires AppendRoom. The table holds a reference
+    // to its append chunk, so that it is not freed while still being
+    // filled.
+    if (AppendFits(table, count)) return;
+    int chunk = ChunkAlloc();
+    ChunkRetain(chunk, 1);
+    if (table->append_fill) {
+        ChunkRelease(table->append_chunk, 1);
+    }
+    table->append_chunk = chunk;
+    table->append_fill = 0;
+    shared_symbols[chunk] = 0;
+}
+
+static int Append(struct PieceTable *table, char c) {
+    // Requires AppendStart first.
+    int at = table->append_chunk * CHUNK_SYMBOLS + table->append_fill++;
+    PackedSet(chunk_arena, at, c);
+    return at;
+}
+
+static bool MergePieces(struct PieceTable *table) {
+    // Replaces the shortest pair of neighbouring pieces by a copy of
+    // both. PieceTableCollect frees their old characters later.
+    int best = -1;
+    int length = CHUNK_SYMBOLS + 1;
+    for (int k = 0; k + 1 < table->piece_count; ++k) {
+        int pair = table->pieces[k].length + table->pieces[k + 1].length;
+        if (pair < length) {
+            best = k;
+            length = pair;
+        }
+    }
+    if (best < 0 || !AppendRoom(table, length)) return false;
+    AppendStart(table, length);
+    int start = table->append_chunk * CHUNK_SYMBOLS + table->append_fill;
+    for (int k = best; k < best + 2; ++k) {
+        for (int i = 0; i < table->pieces[k].length; ++i) {
+            Append(table, PackedGet(chunk_arena, table->pieces[k].start + i));
+        }
+        ChunkRelease(ChunkOf(&table->pieces[k]), table->pieces[k].length);
+    }
+    ChunkRetain(table->append_chunk, length);
+    table->pieces[best].start = start;
+    table->pieces[best].length = length;
+    ShiftPieces(table, best + 2, -1);
+    table->cache_piece = 0;
+    table->cache_start = 0;
+    return true;
+}
+
+static bool MakeRoom(struct PieceTable *table, int pieces, int chars) {
+    // Merges pieces until there are enough free ones, then checks
+    // that chars symbols can be appended.
+    while (table->piece_count + pieces > PIECE_TABLE_MAX_PIECES) {
+        if (!MergePieces(table)) return false;
+    }
+    return !chars || AppendRoom(table, chars);
+}
+
+bool PieceTableCanInsert(struct PieceTable *table) {
+    return MakeRoom(table, 2, 1);
+}
+
+char PieceTableCharAt(struct PieceTable *table, int position) {
+    if (position < 0) return '\0';
+    int i = position - table->window_start;
+    if (i >= 0 && i < table->window_length) return table->window[i];
+    int offset;
+    int k = Locate(table, position, &offset);
+    if (k == table->piece_count) return '\0';
+    // Decode the group of the symbol, as far as it is in the piece.
+    const struct Piece *piece = &table->pieces[k];
+    int at = piece->start + offset;
+    int first = at - at % PIECE_TABLE_WINDOW;
+    int end = first + PIECE_TABLE_WINDOW;
+    if (first < piece->start) first = piece->start;
+    if (end > piece->start + piece->length) {
+        end = piece->start + piece->length;
+    }
+    PackedRead(chunk_arena, first, end - first, table->window);
+    table->window_start = position - (at - first);
+    table->window_length = end - first;
+    return table->window[at - first];
+}
+
+int PieceTableRead(struct PieceTable *table, int position, int count,
+                   char *out) {
+    if (position < 0 || count <= 0 || position >= table->length) return 0;
+    if (count > table->length - position) count = table->length - position;
+    int offset;
+    int k = Locate(table, position, &offset);
+    for (int copied = 0; copied < count; ++k, offset = 0) {
+        int n = table->pieces[k].length - offset;
+        if (n > count - copied) n = count - copied;
+        PackedRead(chunk_arena, table->pieces[k].start + offset, n,
+                   out + copied);
+        copied += n;
+    }
+    return count;
+}
+
+bool PieceTableInsert(struct PieceTable *table, int position, char c) {
+    table->window_length = 0;
+    int offset;
+    int k = Locate(table, position, &offset);
+    // Typing continues the most recently added piece.
+    if (offset == 0 && k > 0 && table->append_fill &&
+        table->append_fill < CHUNK_SYMBOLS &&
+        table->pieces[k - 1].start + table->pieces[k - 1].length ==
+            table->append_chunk * CHUNK_SYMBOLS + table->append_fill) {
+        Append(table, c);
+        ChunkRetain(table->append_chunk, 1);
+        // Keep the cached piece start valid.
+        table->cache_piece = k - 1;
+        table->cache_start -= table->pieces[k - 1].length;
+        table->pieces[k - 1].length++;
+        table->length++;
+        return true;
+    }
+    if (!MakeRoom(table, 2, 1)) return false;
+    k = Locate(table, position, &offset);
+    if (offset > 0) {
+        Split(table, k, offset);
+        ++k;
+    }
+    ShiftPieces(table, k, 1);
+    AppendStart(table, 1);
+    table->pieces[k].start = Append(table, c);
+    table->pieces[k].length = 1;
+    ChunkRetain(table->append_chunk, 1);
+    table->length++;
+    return true;
+}
+
+bool PieceTableReplace(struct PieceTable *table, int position, char c) {
+    if (position < 0 || position >= table->length) return false;
+    int offset;
+    int k = Locate(table, position, &offset);
+    int at = table->pieces[k].start + offset;
+    if (at % CHUNK_SYMBOLS >= shared_symbols[at / CHUNK_SYMBOLS]) {
+        table->window_length = 0;
+        PackedSet(chunk_arena, at, c);
+        return true;
+    }
+    // Room for both the delete and the insert, so that none of them fails.
+    if (!MakeRoom(table, 3, 1)) return false;
+    PieceTableDelete(table, position, 1);
+    return PieceTableInsert(table, position, c);
+}
+
+bool PieceTableDelete(struct PieceTable *table, int position, int count) {
+    if (count > table->length - position) count = table->length - position;
+    if (position < 0 || count <= 0) return true;
+    if (!MakeRoom(table, 1, 0)) return false;
+    table->window_length = 0;
+    int offset;
+    int k = Locate(table, position, &offset);
+    if (offset > 0) {
+        Split(table, k, offset);
+        ++k;
+    }
+    // Drop the pieces covered by the range and trim the last one.
+    int first = k;
+    int remaining = count;
+    while (remaining > 0 && table->pieces[k].length <= remaining) {
+        remaining -= table->pieces[k].length;
+        ChunkRelease(ChunkOf(&table->pieces[k]), table->pieces[k].length);
+        ++k;
+    }
+    if (remaining > 0) {
+        ChunkRelease(ChunkOf(&table->pieces[k]), remaining);
+        table->pieces[k].start += remaining;
+        table->pieces[k].length -= remaining;
+    }
+    ShiftPieces(table, k, first - k);
+    table->length -= count;
+    return true;
+}
+
+bool PieceTableCopy(struct PieceTable *source, int position, int count,
+                    struct PieceTable *target) {
+    if (count > source->length - position) count = source->length - position;
+    PieceTableClear(target);
+    if (position < 0 || count <= 0) return true;
+    int offset;
+    int k = Locate(source, position, &offset);
+    // The range has at most as many pieces as the source.
+    for (; count > 0; ++k, offset = 0) {
+        struct Piece piece = source->pieces[k];
+        piece.start += offset;
+        piece.length -= offset;
+        if (piece.length > count) piece.length = count;
+        target->pieces[target->piece_count++] = piece;
+        target->length += piece.length;
+        count -= piece.length;
+        // The copied characters are now shared.
+        int chunk = ChunkOf(&piece);
+        int end = piece.start + piece.length - chunk * CHUNK_SYMBOLS;
+        ChunkRetain(chunk, piece.length);
+        if (shared_symbols[chunk] < end) {
+            shared_symbols[chunk] = end;
+        }
+    }
+    return true;
+}
+
+bool PieceTablePaste(struct PieceTable *table, int position,
+                     const struct PieceTable *source) {
+    if (!MakeRoom(table, source->piece_count + 1, 0)) return false;
+    table->window_length = 0;
+    int offset;
+    int k = Locate(table, position, &offset);
+    if (offset > 0) {
+        Split(table, k, offset);
+        ++k;
+    }
+    ShiftPieces(table, k, source->piece_count);
+    for (int i = 0; i < source->piece_count; ++i) {
+        table->pieces[k + i] = source->pieces[i];
+        ChunkRetain(ChunkOf(&source->pieces[i]), source->pieces[i].length);
+    }
+    table->length += source->length;
+    return true;
+}
+
+static bool IsAppendChunk(struct PieceTable *const *tables, int count,
+                          int chunk) {
+    for (int t = 0; t < count; ++t) {
+        if (tables[t]->append_fill && tables[t]->append_chunk == chunk) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int VictimOf(const struct Piece *piece, const int *victims) {
+    if (ChunkOf(piece) == victims[0]) return 0;
+    if (ChunkOf(piece) == victims[1]) return 1;
+    return -1;
+}
+
+void PieceTableCollect(struct PieceTable *const *tables, int count) {
+    // Repeatedly moves the referenced symbols of the two least
+    // referenced chunks to a new one, in order, while they fit.
+    static uint32_t referenced[2 * CHUNK_SYMBOLS / 32];
+    static uint16_t moved_to[2 * CHUNK_SYMBOLS];
+    for (;;) {
+        int victims[2] = {-1, -1};
+        for (int c = 0; c < POOL_CHUNKS; ++c) {
+            if (!ChunkReferences(c) || IsAppendChunk(tables, count, c)) {
+                continue;
+            }
+            if (victims[0] < 0 ||
+                ChunkReferences(c) < ChunkReferences(victims[0])) {
+                victims[1] = victims[0];
+                victims[0] = c;
+            } else if (victims[1] < 0 ||
+                       ChunkReferences(c) < ChunkReferences(victims[1])) {
+                victims[1] = c;
+            }
+        }
+        if (victims[1] < 0 || ChunkFreeCount() < 1 ||
+            ChunkReferences(victims[0]) + ChunkReferences(victims[1]) >
+                CHUNK_SYMBOLS) {
+            return;
+        }
+
+        // Mark the referenced symbols, of victims[0] first.
+        memset(referenced, 0, sizeof(referenced));
+        for (int t = 0; t < count; ++t) {
+            for (int k = 0; k < tables[t]->piece_count; ++k) {
+                const struct Piece *piece = &tables[t]->pieces[k];
+                int v = VictimOf(piece, victims);
+                if (v < 0) continue;
+                int bit = v * CHUNK_SYMBOLS + piece->start % CHUNK_SYMBOLS;
+                for (int i = 0; i < piece->length; ++i, ++bit) {
+                    referenced[bit / 32] |= 1U << (bit % 32);
+                }
+            }
+        }
+
+        // Copy them, remembering where each one went.
+        int target = ChunkAlloc();
+        int fill = 0;
+        for (int bit = 0; bit < 2 * CHUNK_SYMBOLS; ++bit) {
+            if (!(referenced[bit / 32] & 1U << (bit % 32))) continue;
+            int from = victims[bit / CHUNK_SYMBOLS] * CHUNK_SYMBOLS +
+                       bit % CHUNK_SYMBOLS;
+            moved_to[bit] = fill;
+            PackedSet(chunk_arena, target * CHUNK_SYMBOLS + fill++,
+                      PackedGet(chunk_arena, from));
+        }
+        shared_symbols[target] = fill;
+
+        for (int t = 0; t < count; ++t) {
+            for (int k = 0; k < tables[t]->piece_count; ++k) {
+                struct Piece *piece = &tables[t]->pieces[k];
+                int v = VictimOf(piece, victims);
+                if (v < 0) continue;
+                int bit = v * CHUNK_SYMBOLS + piece->start % CHUNK_SYMBOLS;
+                piece->start = target * CHUNK_SYMBOLS + moved_to[bit];
+            }
+        }
+        ChunkRetain(target, ChunkReferences(victims[0]) +
+                            ChunkReferences(victims[1]));
+        ChunkRelease(victims[0], ChunkReferences(victims[0]));
+        ChunkRelease(victims[1], ChunkReferences(victims[1]));
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef _PIECE_TABLE_H
+#define _PIECE_TABLE_H 1
+
+#include <stdbool.h>
+#include "chunk_pool.h"
+
+// Characters are appended to chunks of the pool and never move,
+// except when the pool is collected. A piece never crosses a chunk
+// border, so a document of PIECE_TABLE_MAX_PIECES / 2 full chunks
+// always fits.
+#define PIECE_TABLE_MAX_PIECES 256
+// PieceTableCharAt decodes a whole group of packed symbols at once.
+#define PIECE_TABLE_WINDOW 4
+
+// A span of the chunk arena, within a single chunk.
+struct Piece {
+    int start;
+    int length;
+};
+
+// Text as a sequence of pieces. Copying text between tables
+// copies the pieces only, never the characters.
+struct PieceTable {
+    struct Piece pieces[PIECE_TABLE_MAX_PIECES];
+    int piece_count;
+    int length;
+    // The last located piece and its text position. Lookups start
+    // from there, as they are mostly near the cursor.
+    int cache_piece;
+    int cache_start;
+    // The characters from window_start on, decoded by the last
+    // PieceTableCharAt for the calls next to it. Edits empty it.
+    char window[PIECE_TABLE_WINDOW];
+    int window_start;
+    int window_length;
+    // The chunk new characters are appended to, if append_fill > 0.
+    int append_chunk;
+    int append_fill;
+};
+
+// Frees the table's pieces. A zeroed table is clear too.
+void PieceTableClear(struct PieceTable *table);
+// May rearrange the pieces to make room.
+bool PieceTableCanInsert(struct PieceTable *table);
+// Merges sparsely used chunks to free some. The tables must be all
+// the tables in use. Afterwards at most one chunk, besides the ones
+// being appended to, is half empty or worse.
+void PieceTableCollect(struct PieceTable *const *tables, int count);
+
+char PieceTableCharAt(struct PieceTable *table, int position);
+// Copies up to count characters to out, returns how many were copied.
+int PieceTableRead(struct PieceTable *table, int position, int count,
+                   char *out);
+
+// These functions return false and leave the text unchanged
+// when they run out of pieces or chunks.
+bool PieceTableInsert(struct PieceTable *table, int position, char c);
+bool PieceTableReplace(struct PieceTable *table, int position, char c);
+bool PieceTableDelete(struct PieceTable *table, int position, int count);
+// Makes target refer to count characters of source.
+bool PieceTableCopy(struct PieceTable *source, int position, int count,
+                    struct PieceTable *target);
+// Inserts the whole source at the given position, in time and
+// memory independent of the source length.
+bool PieceTablePaste(struct PieceTable *table, int position,
+                     const struct PieceTable *source);
+
+#endif
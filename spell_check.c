@@ -0,0 +1,78 @@
+#include <stdbool.h>
+#include "lcd_geometry.h"
+#include "spell_check.h"
+#include "synced_lcd.h"
+
+#define SCREEN_SIZE (LCD_TEXT_WIDTH * LCD_TEXT_HEIGHT)
+// Shorter words are not checked.
+#define SPELL_MIN_LENGTH 2
+
+// The screen version the underlines were computed for.
+static unsigned checked_version = 0;
+static bool checked = false;
+
+static bool IsLetter(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static bool IsWordChar(char c) {
+    return IsLetter(c) || (c >= '0' && c <= '9');
+}
+
+static bool IsUnknown(const char *cells, const bool *cursor, int from,
+                      int to) {
+    // A word is checked once it is fixed: not at or next to the
+    // cursor, the inverse cell, which shows it is still being typed,
+    // and not at an edge of the screen, where it may go on. Words
+    // with digits are not checked at all.
+    if (from == 0 || to == SCREEN_SIZE) return false;
+    for (int i = from - 1; i <= to; ++i) {
+        if (cursor[i]) return false;
+    }
+    if (to - from < SPELL_MIN_LENGTH) return false;
+    for (int i = from; i < to; ++i) {
+        if (!IsLetter(cells[i])) return false;
+    }
+    return !BloomContains(&spell_dictionary, cells + from, to - from);
+}
+
+void SpellCheckIdle(void) {
+    unsigned version = SyncedLCDversion();
+    if (checked && version == checked_version) return;
+
+    // The cells change under the keyboard interrupt, so they are
+    // copied first and the result is dropped if they changed
+    // meanwhile. The next call checks them again.
+    char cells[SCREEN_SIZE];
+    bool cursor[SCREEN_SIZE];
+    bool unknown[SCREEN_SIZE];
+    for (int i = 0; i < SCREEN_SIZE; ++i) {
+        int row = i / LCD_TEXT_WIDTH;
+        int col = i % LCD_TEXT_WIDTH;
+        cells[i] = SyncedLCDcharAt(row, col);
+        cursor[i] = SyncedLCDattributesAt(row, col) & ATTR_INVERSE;
+        unknown[i] = false;
+    }
+    for (int from = 0; from < SCREEN_SIZE;) {
+        if (!IsWordChar(cells[from])) {
+            ++from;
+            continue;
+        }
+        int to = from;
+        while (to < SCREEN_SIZE && IsWordChar(cells[to])) ++to;
+        if (IsUnknown(cells, cursor, from, to)) {
+            for (int i = from; i < to; ++i) {
+                unknown[i] = true;
+            }
+        }
+        from = to;
+    }
+    if (SyncedLCDversion() != version) return;
+
+    for (int i = 0; i < SCREEN_SIZE; ++i) {
+        SyncedLCDunderline(i / LCD_TEXT_WIDTH, i % LCD_TEXT_WIDTH,
+                           unknown[i]);
+    }
+    checked_version = version;
+    checked = true;
+}
@@ -0,0 +1,21 @@
+#ifndef _SPELL_CHECK_H
+#define _SPELL_CHECK_H 1
+
+#include "bloom_filter.h"
+
+// The shipped dictionary is built from host/words.txt, a seed list
+// of about a thousand words, which would underline most of what is
+// typed. Until it is rebuilt from a full word list, see "make
+// dictionary" in host/, the check is only linked into the host
+// replay and not into the firmware.
+
+// The dictionary, generated by host/spellgen into
+// spell_dictionary.c and kept in flash.
+extern const struct BloomFilter spell_dictionary;
+
+// Underlines the words on the screen that are not in the
+// dictionary. To be called from the main loop between syncs, it
+// does nothing unless the screen changed.
+void SpellCheckIdle(void);
+
+#endif
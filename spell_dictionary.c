@@ -0,0 +1,100 @@
+// Generated by host/spellgen from 1114 words, do not edit.
+#include "spell_check.h"
+
+static const uint8_t bits[1114] = {
+    0x4a, 0xfc, 0x6b, 0x56, 0x11, 0x9a, 0x14, 0x26, 0x3a, 0xfe, 0x3d, 0x0c,
+    0xbd, 0x34, 0xd8, 0xfc, 0xad, 0x87, 0x8f, 0x82, 0x2d, 0x87, 0xd2, 0x18,
+    0x34, 0x74, 0x0f, 0xfc, 0xc8, 0xe0, 0x31, 0x3c, 0x41, 0x22, 0xfa, 0x86,
+    0x42, 0x32, 0xa1, 0x32, 0x03, 0x6e, 0x46, 0x06, 0x6c, 0x8b, 0xc6, 0xa7,
+    0x51, 0x85, 0x82, 0x58, 0xa2, 0x4b, 0x0e, 0x21, 0xe0, 0x00, 0x98, 0x35,
+    0xaa, 0xb2, 0x80, 0x07, 0xe8, 0xa2, 0x46, 0x61, 0x34, 0xcd, 0x4a, 0xf9,
+    0x83, 0x9c, 0x46, 0x41, 0x2a, 0x96, 0x61, 0xc3, 0x11, 0x58, 0x2c, 0xc6,
+    0xf1, 0xba, 0xd9, 0x01, 0xb2, 0x1c, 0x45, 0x00, 0xf7, 0x43, 0x31, 0xc7,
+    0xc3, 0x00, 0xa0, 0xe6, 0x52, 0x81, 0xe8, 0x60, 0x07, 0xc0, 0xc7, 0x37,
+    0xf9, 0xcc, 0xec, 0x42, 0x00, 0xa2, 0xe4, 0x21, 0x28, 0x67, 0xcb, 0x28,
+    0xd2, 0x82, 0x0a, 0x45, 0x3e, 0x1c, 0x5b, 0x57, 0x77, 0x4e, 0x2a, 0x7a,
+    0x26, 0x02, 0xda, 0x20, 0x97, 0xc4, 0x9e, 0xc9, 0x0b, 0x9a, 0xca, 0x28,
+    0xcb, 0xda, 0xfc, 0xbe, 0x04, 0x78, 0x47, 0x97, 0x45, 0x28, 0x28, 0x5a,
+    0x45, 0xdc, 0xb7, 0x49, 0x39, 0x2f, 0x0e, 0xc4, 0x9a, 0xd9, 0xc7, 0x42,
+    0xc9, 0x7c, 0x50, 0x84, 0x4e, 0x17, 0x27, 0x46, 0xd5, 0x67, 0xa1, 0x58,
+    0x0f, 0x18, 0x82, 0x6e, 0xbd, 0x84, 0xc0, 0xb7, 0xa1, 0xab, 0x90, 0x04,
+    0xe6, 0x1e, 0x3c, 0x90, 0x27, 0x5a, 0xbd, 0x51, 0x41, 0x78, 0x91, 0xc8,
+    0x27, 0xd1, 0xe4, 0xcb, 0xc4, 0x3f, 0x9a, 0xf5, 0x5e, 0x89, 0x82, 0x2c,
+    0x18, 0x43, 0x5f, 0x8c, 0xc9, 0x20, 0x8c, 0x55, 0xe1, 0x38, 0x2b, 0x84,
+    0x2c, 0xe5, 0xd7, 0x9d, 0xb1, 0xec, 0x13, 0x86, 0x0b, 0x3d, 0xbb, 0x84,
+    0x15, 0x9f, 0xb0, 0x38, 0x9b, 0x2c, 0x45, 0xa7, 0xb3, 0xd1, 0x60, 0x91,
+    0x99, 0xf3, 0x70, 0xac, 0x87, 0xa5, 0xc8, 0x3d, 0x88, 0x6c, 0x89, 0xb8,
+    0x2a, 0x39, 0xeb, 0x5a, 0x55, 0x55, 0x7e, 0x30, 0xf6, 0x08, 0xac, 0xcd,
+    0x40, 0x45, 0xbd, 0x35, 0x5c, 0x80, 0x25, 0x48, 0x04, 0xa5, 0x9b, 0xf4,
+    0x8a, 0x25, 0x38, 0xa4, 0x1d, 0x40, 0xf8, 0x15, 0x2d, 0x86, 0xb5, 0xe9,
+    0x61, 0x20, 0x9c, 0xce, 0xff, 0x12, 0xf6, 0x84, 0x10, 0x51, 0x70, 0x81,
+    0xf4, 0x8b, 0x0c, 0x88, 0x01, 0xea, 0x73, 0x36, 0x23, 0x85, 0xe1, 0x41,
+    0x9b, 0xff, 0x9c, 0x8b, 0xc3, 0x07, 0xa8, 0xa3, 0xf2, 0x50, 0x3a, 0x73,
+    0x04, 0xb9, 0xb2, 0x69, 0x0e, 0xb7, 0x2f, 0xfd, 0x70, 0xcc, 0xe3, 0xd7,
+    0xc2, 0x65, 0xc5, 0x24, 0x60, 0xe5, 0x42, 0x23, 0x08, 0x49, 0x65, 0xc2,
+    0xcf, 0x74, 0x16, 0x27, 0x71, 0x67, 0x16, 0xe7, 0xdc, 0x45, 0xbd, 0x87,
+    0xc8, 0x41, 0x89, 0x48, 0x36, 0x62, 0x4d, 0xc6, 0x53, 0x24, 0xbd, 0xd4,
+    0x70, 0xcf, 0x9e, 0x0e, 0x5b, 0x09, 0xe0, 0x5c, 0xa4, 0x03, 0x63, 0xc3,
+    0x95, 0xf7, 0xa3, 0x99, 0xf3, 0x0e, 0xe6, 0x33, 0xbb, 0x71, 0x38, 0x77,
+    0xb0, 0x50, 0x08, 0xe5, 0x1e, 0x93, 0xe2, 0x91, 0x59, 0xe4, 0x43, 0x09,
+    0x14, 0x2e, 0x8c, 0x00, 0xe2, 0xdb, 0x55, 0xc7, 0x0e, 0xa7, 0x8e, 0x61,
+    0x50, 0x50, 0xec, 0x12, 0xc9, 0xc6, 0xc4, 0x10, 0xf5, 0xd5, 0x11, 0x67,
+    0xa5, 0x1a, 0x20, 0x29, 0x0b, 0xf8, 0x4e, 0x90, 0xc1, 0xc7, 0x35, 0xe0,
+    0x88, 0xb0, 0xd0, 0x96, 0x88, 0xab, 0xb5, 0x82, 0x2a, 0x57, 0x27, 0xf3,
+    0x3b, 0x56, 0x78, 0x7b, 0x73, 0x0a, 0x51, 0xf8, 0xb6, 0xf2, 0xe2, 0x2e,
+    0x1b, 0x6c, 0x1f, 0x40, 0x1f, 0x25, 0x09, 0x20, 0x88, 0x69, 0x09, 0x14,
+    0x3e, 0x4f, 0x84, 0x38, 0xff, 0x59, 0xa3, 0x78, 0xa0, 0x2e, 0xb0, 0x98,
+    0x57, 0xdc, 0x60, 0x6a, 0x52, 0x4e, 0x81, 0x9b, 0x68, 0x7c, 0x6a, 0x0b,
+    0xe3, 0x2b, 0xe3, 0x21, 0x19, 0xc0, 0x4f, 0x14, 0x00, 0xd3, 0x18, 0xf0,
+    0x54, 0x0c, 0x07, 0x22, 0xe3, 0xa0, 0x14, 0xb2, 0xc1, 0xf0, 0x2c, 0xe5,
+    0xfd, 0xec, 0x90, 0x80, 0x63, 0xd9, 0x32, 0x33, 0x1a, 0x91, 0xe9, 0x75,
+    0xc0, 0x11, 0x0e, 0x16, 0xcc, 0x2b, 0x10, 0xcd, 0xe9, 0x95, 0x5f, 0xca,
+    0x01, 0x1e, 0x86, 0xd6, 0x0f, 0x3c, 0x44, 0x05, 0x17, 0xa7, 0x5c, 0xf1,
+    0xac, 0x99, 0x92, 0x63, 0x2e, 0x9a, 0xa4, 0x1e, 0x06, 0xbe, 0xf4, 0x66,
+    0xa3, 0xfc, 0x20, 0x57, 0x25, 0x1a, 0x8b, 0x73, 0x59, 0x60, 0x24, 0x35,
+    0x9b, 0x3f, 0x7b, 0xab, 0x1d, 0x08, 0x27, 0x09, 0xfd, 0xd4, 0xf3, 0xd8,
+    0x71, 0x7d, 0x91, 0xe1, 0x80, 0x91, 0x9b, 0xd8, 0x14, 0x3f, 0xaa, 0xb8,
+    0x5f, 0xc5, 0x97, 0xa2, 0xfe, 0xee, 0x6c, 0x7c, 0xdb, 0x1f, 0x2a, 0xee,
+    0xe5, 0xb0, 0xe0, 0x0d, 0x20, 0x65, 0x37, 0xbb, 0xa5, 0x67, 0xa0, 0xd1,
+    0x12, 0xd9, 0x47, 0x1a, 0xbe, 0xf8, 0x1a, 0xfa, 0x24, 0x30, 0x60, 0x9e,
+    0x06, 0xf5, 0x85, 0xf9, 0xd0, 0xe7, 0x3f, 0x5b, 0x86, 0x01, 0x2d, 0x2c,
+    0x42, 0x0d, 0x52, 0xc6, 0x38, 0xb9, 0x7c, 0xa0, 0x66, 0x1a, 0x1f, 0xa0,
+    0x2d, 0x04, 0xfe, 0x5d, 0xaa, 0xe9, 0xe6, 0x40, 0x21, 0x0b, 0x05, 0x53,
+    0x55, 0x92, 0x0f, 0x24, 0x91, 0x04, 0x51, 0x6b, 0x02, 0x3b, 0xc1, 0xe5,
+    0x6c, 0x9a, 0x80, 0x83, 0xac, 0x40, 0x19, 0x62, 0x87, 0x29, 0xe2, 0x47,
+    0xe6, 0xd3, 0x3e, 0x17, 0xa8, 0x1e, 0xec, 0x13, 0x40, 0xb8, 0xa0, 0xb0,
+    0x85, 0x20, 0x41, 0x2a, 0x80, 0x74, 0x6c, 0x00, 0xa6, 0x72, 0x75, 0x49,
+    0x09, 0x56, 0xf0, 0x60, 0x26, 0x46, 0x05, 0xb3, 0x77, 0x03, 0xd3, 0x94,
+    0xdc, 0x78, 0xa3, 0x59, 0xe2, 0x1f, 0xa4, 0xa8, 0x3a, 0xa6, 0x6c, 0x96,
+    0x2f, 0x5c, 0xf9, 0xd7, 0xe8, 0x83, 0xb8, 0x34, 0xd1, 0x10, 0x78, 0x30,
+    0xbd, 0xcc, 0xe0, 0xc9, 0x1a, 0x6c, 0x0c, 0x38, 0x73, 0x02, 0xc6, 0xf5,
+    0x9a, 0x18, 0x3e, 0x9d, 0x32, 0xc6, 0xc5, 0x40, 0x34, 0x4b, 0xf2, 0x7f,
+    0xc6, 0x01, 0x79, 0x26, 0x77, 0x98, 0xc5, 0x92, 0x1e, 0x39, 0x04, 0x8d,
+    0x3a, 0xc1, 0xa8, 0xcc, 0xfe, 0x72, 0x6f, 0x86, 0xf5, 0xbc, 0xe7, 0x73,
+    0x83, 0xdc, 0xb0, 0xee, 0x4f, 0xfc, 0xb2, 0x8c, 0x17, 0x1d, 0xca, 0xf5,
+    0x23, 0x16, 0x40, 0x47, 0x3e, 0xd3, 0x54, 0x93, 0x2c, 0x8b, 0x0c, 0x08,
+    0x16, 0xf7, 0x11, 0x1f, 0x46, 0x33, 0x00, 0xe9, 0x2f, 0x8c, 0x5d, 0x36,
+    0x7e, 0x60, 0xf3, 0x37, 0xd1, 0x15, 0x52, 0xdf, 0xb8, 0x8b, 0x94, 0x69,
+    0x32, 0x7a, 0xfe, 0x91, 0x4a, 0xc4, 0x83, 0x97, 0x2c, 0xae, 0x3a, 0x84,
+    0xf9, 0xf5, 0x1b, 0xac, 0xe3, 0x16, 0x46, 0xaf, 0x28, 0x16, 0xf0, 0x08,
+    0x64, 0x08, 0x3c, 0x34, 0x45, 0x25, 0x56, 0xb4, 0x49, 0x5f, 0xd6, 0xc0,
+    0xab, 0x90, 0x70, 0xe4, 0x02, 0x46, 0x82, 0x06, 0x36, 0x28, 0x14, 0x9f,
+    0x93, 0xfb, 0xb9, 0x14, 0x0b, 0xb6, 0xc2, 0xa7, 0x1b, 0x8c, 0xe6, 0xa0,
+    0xa0, 0xa4, 0x1a, 0x4a, 0x1c, 0x1c, 0xb5, 0x8f, 0xf5, 0x13, 0x46, 0x2c,
+    0x64, 0x95, 0xd2, 0xf8, 0x67, 0xd2, 0xe2, 0x03, 0x9e, 0x76, 0x23, 0x85,
+    0x68, 0x1a, 0x63, 0x12, 0x24, 0x73, 0x3a, 0x8a, 0x75, 0x3f, 0x7f, 0xf9,
+    0xfa, 0xf7, 0x9f, 0x9d, 0x56, 0xf1, 0x1c, 0x42, 0xce, 0x92, 0xbd, 0x02,
+    0x53, 0x7c, 0x18, 0x83, 0xd2, 0xe8, 0x75, 0x74, 0x80, 0xa5, 0xf4, 0x6d,
+    0x81, 0xfd, 0xa4, 0xdb, 0xd9, 0x21, 0x89, 0x8a, 0x51, 0x80, 0x59, 0x1b,
+    0x03, 0x9a, 0x87, 0x5a, 0x09, 0x1e, 0x3a, 0x1a, 0x6b, 0xb2, 0x79, 0xcc,
+    0x6b, 0xab, 0x8b, 0xff, 0x90, 0xa9, 0x76, 0x34, 0x5c, 0x4e, 0xcb, 0x59,
+    0x52, 0x26, 0xd2, 0xb3, 0xfc, 0x06, 0x88, 0xc1, 0x87, 0xa3, 0x6b, 0xe1,
+    0x8c, 0x14, 0xd8, 0x86, 0xd1, 0xce, 0x71, 0x4a, 0x71, 0x59, 0x46, 0xf4,
+    0x37, 0x4c, 0x55, 0x47, 0x74, 0x3c, 0x09, 0x1c, 0x51, 0x61, 0x51, 0x41,
+    0x29, 0x9f, 0x39, 0x18, 0x1a, 0xc3, 0x20, 0xf9, 0xbb, 0x01, 0x84, 0xf8,
+    0x31, 0xc4, 0x87, 0x96, 0x66, 0xac, 0x94, 0x5b, 0x9f, 0x1e, 0xc5, 0x33,
+    0xb1, 0x00, 0x64, 0x96, 0x65, 0x7a, 0x53, 0xee, 0x0e, 0xc4, 0x63, 0x72,
+    0x31, 0x23, 0x8b, 0x24, 0x32, 0xaf, 0xb9, 0xb3, 0x12, 0x33,
+};
+
+const struct BloomFilter spell_dictionary = {8912, 5, bits};
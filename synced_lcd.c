@@ -1,35 +1,75 @@
-#define WIDTH 9
-#define HEIGHT 5
-
 #include <stdbool.h>
 #include "synced_lcd.h"
 #include "lcd.h"
+#include "lcd_geometry.h"
+
+#define WIDTH LCD_TEXT_WIDTH
+#define HEIGHT LCD_TEXT_HEIGHT
 
 static char state[HEIGHT][WIDTH];
+static uint8_t attributes[HEIGHT][WIDTH];
 static int current_row, current_col;
-static bool is_synced[HEIGHT][WIDTH];
+static uint8_t current_attributes = ATTR_DEFAULT;
+// What the LCD currently displays. A cell is redrawn only if
+// it differs from the state, so cells rewritten many times between
+// two syncs, or rewritten with the same character, cost nothing.
+static char shown[HEIGHT][WIDTH];
+static uint8_t shown_attributes[HEIGHT][WIDTH];
+// Counts changes of the state.
+static volatile unsigned version = 0;
+static bool underlined[HEIGHT][WIDTH];
+
+static const uint16_t foreground_palette[4] = {
+    LCD_COLOR_WHITE, LCD_COLOR_YELLOW, LCD_COLOR_CYAN, LCD_COLOR_BLACK,
+};
+static const uint16_t background_palette[4] = {
+    LCD_COLOR_BLUE, LCD_COLOR_BLACK, LCD_COLOR_GREEN, LCD_COLOR_RED,
+};
 
 void SyncedLCDconfigure(void) {
     SyncedLCDclear();
     LCDconfigure();
+    // LCDconfigure blanks the whole screen.
+    for (int i = 0; i < HEIGHT; ++i) {
+        for (int j = 0; j < WIDTH; ++j) {
+            shown[i][j] = ' ';
+            shown_attributes[i][j] = ATTR_DEFAULT;
+        }
+    }
     SyncedLCDsync();
 }
 
+static void SetCell(int row, int col, char c, uint8_t cell_attributes) {
+    if (state[row][col] != c) {
+        // The underline was for the word the cell was part of, and
+        // would show under the new character until the next check.
+        underlined[row][col] = false;
+    }
+    if (state[row][col] != c || attributes[row][col] != cell_attributes) {
+        state[row][col] = c;
+        attributes[row][col] = cell_attributes;
+        ++version;
+    }
+}
+
 void SyncedLCDclear(void) {
     for (int i = 0; i < HEIGHT; ++i) {
         for (int j = 0; j < WIDTH; ++j) {
-            state[i][j] = ' ';
-            is_synced[i][j] = false;
+            SetCell(i, j, ' ', ATTR_DEFAULT);
         }
     }
     current_row = 0;
     current_col = 0;
+    current_attributes = ATTR_DEFAULT;
+}
+
+void SyncedLCDsetAttributes(uint8_t cell_attributes) {
+    current_attributes = cell_attributes;
 }
 
 void SyncedLCDputcharWrap(char c) {
     if (current_row < HEIGHT && current_col < WIDTH) {
-        state[current_row][current_col] = c;
-        is_synced[current_row][current_col] = false;
+        SetCell(current_row, current_col, c, current_attributes);
     }
     // Advance position.
     if (current_col + 1 < WIDTH) {
@@ -49,19 +89,65 @@ void SyncedLCDbackspace(void) {
     }
     if (current_row >= 0 && current_row < HEIGHT &&
         current_col >= 0 && current_col < WIDTH) {
-        state[current_row][current_col] = ' ';
-        is_synced[current_row][current_col] = false;
+        SetCell(current_row, current_col, ' ', current_attributes);
     }
 }
 
+static uint8_t CellAttributes(int row, int col) {
+    return attributes[row][col] | (underlined[row][col] ? ATTR_UNDERLINE : 0);
+}
+
+static uint16_t Foreground(uint8_t cell_attributes) {
+    return cell_attributes & ATTR_INVERSE
+        ? background_palette[(cell_attributes & ATTR_BG_MASK) >> 2]
+        : foreground_palette[cell_attributes & ATTR_FG_MASK];
+}
+
+static uint16_t Background(uint8_t cell_attributes) {
+    return cell_attributes & ATTR_INVERSE
+        ? foreground_palette[cell_attributes & ATTR_FG_MASK]
+        : background_palette[(cell_attributes & ATTR_BG_MASK) >> 2];
+}
+
+static bool IsShown(int row, int col, char c, uint8_t cell_attributes) {
+    return c == shown[row][col] &&
+        cell_attributes == shown_attributes[row][col];
+}
+
 void SyncedLCDsync() {
-    LCDgoto(0, 0);
     for (int i = 0; i < HEIGHT; ++i) {
-        for (int j = 0; j < WIDTH; ++j) {
-            if (is_synced[i][j]) continue;
+        for (int j = 0; j < WIDTH;) {
+            // Read once, the state may change under an interrupt.
+            char c = state[i][j];
+            uint8_t a = CellAttributes(i, j);
+            if (IsShown(i, j, c, a)) {
+                ++j;
+                continue;
+            }
             LCDgoto(i, j);
-            LCDputchar(state[i][j]);
-            is_synced[i][j] = true;
+            if (c == shown[i][j] &&
+                (a ^ shown_attributes[i][j]) == ATTR_UNDERLINE) {
+                // Only the underline changed.
+                LCDunderline(c, a & ATTR_UNDERLINE, Foreground(a),
+                             Background(a));
+                shown_attributes[i][j] = a;
+                ++j;
+                continue;
+            }
+            // Changed cells that follow with the same attributes are
+            // drawn along, in the same window.
+            char run[WIDTH];
+            int count = 0;
+            while (true) {
+                run[count++] = c;
+                shown[i][j] = c;
+                shown_attributes[i][j] = a;
+                if (++j == WIDTH) break;
+                c = state[i][j];
+                if (CellAttributes(i, j) != a || IsShown(i, j, c, a)) break;
+            }
+            LCDputchars(run, count, Foreground(a), Background(a),
+                        a & ATTR_UNDERLINE);
         }
     }
 }
@@ -70,3 +156,19 @@ void SyncedLCDgoto(int row, int col) {
     current_row = row;
     current_col = col;
 }
+
+char SyncedLCDcharAt(int row, int col) {
+    return state[row][col];
+}
+
+uint8_t SyncedLCDattributesAt(int row, int col) {
+    return attributes[row][col];
+}
+
+unsigned SyncedLCDversion(void) {
+    return version;
+}
+
+void SyncedLCDunderline(int row, int col, bool on) {
+    underlined[row][col] = on;
+}
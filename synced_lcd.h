@@ -1,11 +1,34 @@
 #ifndef _SYNCED_LCD_H
 #define _SYNCED_LCD_H 1
 
+#include <stdbool.h>
+#include <stdint.h>
+
+// Cell attributes, a byte per cell: the foreground and background
+// colours, as indexes into the palettes of synced_lcd.c, and
+// whether the colours are swapped or the cell is underlined.
+#define ATTR_FG_WHITE   0x00
+#define ATTR_FG_YELLOW  0x01
+#define ATTR_FG_CYAN    0x02
+#define ATTR_FG_BLACK   0x03
+#define ATTR_FG_MASK    0x03
+#define ATTR_BG_BLUE    0x00
+#define ATTR_BG_BLACK   0x04
+#define ATTR_BG_GREEN   0x08
+#define ATTR_BG_RED     0x0C
+#define ATTR_BG_MASK    0x0C
+#define ATTR_INVERSE    0x10
+#define ATTR_UNDERLINE  0x20
+#define ATTR_DEFAULT    (ATTR_FG_WHITE | ATTR_BG_BLUE)
+
 // These functions operate on device memory only
 // without communicating with LCD.
 void SyncedLCDconfigure(void);
 void SyncedLCDclear(void);
 void SyncedLCDgoto(int textLine, int charPos);
+// Attributes of the cells written from now on, ATTR_DEFAULT after
+// a clear.
+void SyncedLCDsetAttributes(uint8_t attributes);
 void SyncedLCDputcharWrap(char c);
 void SyncedLCDbackspace(void);
 
@@ -13,4 +36,15 @@ void SyncedLCDbackspace(void);
 // with LCD.
 void SyncedLCDsync(void);
 
+// Reading the cells back, for the main loop. The version changes
+// whenever a cell does, e.g. under an interrupt while reading.
+char SyncedLCDcharAt(int row, int col);
+uint8_t SyncedLCDattributesAt(int row, int col);
+unsigned SyncedLCDversion(void);
+// Underlines are an overlay set from the main loop only, added to
+// the attributes of the cell, and cleared when its character
+// changes. Changing one redraws just the bottom pixel row of the
+// cell.
+void SyncedLCDunderline(int row, int col, bool on);
+
 #endif
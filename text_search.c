@@ -0,0 +1,86 @@
+#include <stdint.h>
+#include <string.h>
+#include "text_search.h"
+
+// Text is read in windows of this many characters, at least
+// SEARCH_MAX_QUERY.
+#define SEARCH_WINDOW 128
+
+static int Find(struct PieceTable *text, const char *pattern, int m,
+                int from, int end) {
+    // Boyer-Moore-Horspool: finds the first match of the pattern
+    // starting at from or later and ending by end, or returns -1.
+    // After a mismatch the window moves by how far from the end of
+    // the pattern the character under its last position occurs.
+    uint8_t skip[128];
+    memset(skip, m, sizeof(skip));
+    for (int i = 0; i < m - 1; ++i) {
+        skip[pattern[i] & 127] = m - 1 - i;
+    }
+    char window[SEARCH_WINDOW];
+    int window_start = from;
+    int window_end = from;
+    for (int position = from; position + m <= end;) {
+        if (position + m > window_end) {
+            window_start = position;
+            window_end = position + PieceTableRead(text, position,
+                                                   SEARCH_WINDOW, window);
+        }
+        const char *candidate = window + (position - window_start);
+        char last = candidate[m - 1];
+        if (last == pattern[m - 1] &&
+            memcmp(candidate, pattern, m - 1) == 0) {
+            return position;
+        }
+        position += skip[last & 127];
+    }
+    return -1;
+}
+
+static int FindWrapping(struct PieceTable *text, const char *pattern,
+                        int m, int from) {
+    // Continues from the start of the text past its end.
+    int found = Find(text, pattern, m, from, text->length);
+    if (found < 0) {
+        int end = from + m - 1;
+        found = Find(text, pattern, m, 0,
+                     end < text->length ? end : text->length);
+    }
+    return found;
+}
+
+void SearchStart(struct Search *search, int from) {
+    search->length = 0;
+    search->from = from;
+}
+
+bool SearchPush(struct Search *search, struct PieceTable *text, char c) {
+    if (search->length == SEARCH_MAX_QUERY) return false;
+    int from = search->length ? search->matches[search->length - 1]
+                              : search->from;
+    search->query[search->length] = c;
+    ++search->length;
+    search->matches[search->length - 1] = from < 0 ? -1
+        : FindWrapping(text, search->query, search->length, from);
+    return true;
+}
+
+bool SearchPop(struct Search *search) {
+    if (search->length == 0) return false;
+    --search->length;
+    return true;
+}
+
+void SearchNext(struct Search *search, struct PieceTable *text) {
+    if (search->length == 0) return;
+    int *match = &search->matches[search->length - 1];
+    if (*match < 0) return;
+    *match = FindWrapping(text, search->query, search->length, *match + 1);
+}
+
+int SearchFound(const struct Search *search, int *length) {
+    int k = search->length;
+    while (k > 0 && search->matches[k - 1] < 0) --k;
+    *length = k;
+    return k ? search->matches[k - 1] : search->from;
+}
@@ -0,0 +1,34 @@
+#ifndef _TEXT_SEARCH_H
+#define _TEXT_SEARCH_H 1
+
+#include "piece_table.h"
+
+#define SEARCH_MAX_QUERY 32
+
+// Incremental search: the query grows and shrinks by one character
+// at a time. A match of a longer query is also a match of its
+// prefix, so each character resumes from the match of the prefix
+// instead of rescanning the text.
+struct Search {
+    char query[SEARCH_MAX_QUERY];
+    int length;
+    // matches[i] is where the first i + 1 characters of the query
+    // were found, or -1. Removing a character just pops a match.
+    int matches[SEARCH_MAX_QUERY];
+    // Where the search started, it wraps around past the end.
+    int from;
+};
+
+void SearchStart(struct Search *search, int from);
+// Both return false, changing nothing, if the query is full
+// or empty respectively.
+bool SearchPush(struct Search *search, struct PieceTable *text, char c);
+bool SearchPop(struct Search *search);
+// Moves to the next match of the whole query, if any.
+void SearchNext(struct Search *search, struct PieceTable *text);
+// Returns where the longest prefix of the query that was found
+// starts, or the start of the search if none. Its length is
+// stored in *length.
+int SearchFound(const struct Search *search, int *length);
+
+#endif